@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Branch misses can be reported alongside the timings with
+// --benchmark_perf_counters=BRANCH-MISSES when benchmark is built with libpfm.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+struct Particle {
+  void Step(float dt) noexcept { x += vx * dt; y += vy * dt; }
+
+  float x, y, vx, vy;
+};
+
+struct Drifter {
+  void Step(float dt) noexcept { x += dt; }
+
+  float x, y;
+};
+
+template <class T>
+void StepAll(std::span<T> bodies, float dt) noexcept {
+  for (T& body : bodies) {
+    body.Step(dt);
+  }
+}
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Accumulate, void(int&) noexcept);
+PRO_DEF_FACADE(Accumulable, Accumulate);
+PRO_DEF_MEMBER_DISPATCH(Step, void(float dt) noexcept);
+PRO_DEF_BULK_DISPATCH(BulkStep, StepAll, void(float dt) noexcept);
+PRO_DEF_FACADE(Body, PRO_MAKE_DISPATCH_PACK(Step, BulkStep));
+
+}  // namespace poly
+
+template <int I>
+class Accumulator {
+ public:
+  void Accumulate(int& sum) const noexcept { sum += value_; }
+
+ private:
+  int value_ = I;
+};
+
+constexpr int kTypeCount = 8;
+
+template <int... Is>
+pro::proxy<poly::Accumulable> MakeAccumulator(
+    int type, std::integer_sequence<int, Is...>) {
+  pro::proxy<poly::Accumulable> result;
+  ((type == Is ? (result = pro::make_proxy<poly::Accumulable, Accumulator<Is>>(), 0) : 0), ...);
+  return result;
+}
+
+std::vector<pro::proxy<poly::Accumulable>> MakeShuffledAccumulators(std::size_t count) {
+  std::vector<pro::proxy<poly::Accumulable>> result;
+  result.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    result.push_back(MakeAccumulator(static_cast<int>(i % kTypeCount), std::make_integer_sequence<int, kTypeCount>{}));
+  }
+  std::shuffle(result.begin(), result.end(), std::mt19937{42u});
+  return result;
+}
+
+void BM_InvokeLoop(benchmark::State& state) {
+  auto proxies = MakeShuffledAccumulators(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& p : proxies) {
+      p.invoke<poly::Accumulate>(sum);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_InvokeBatch(benchmark::State& state) {
+  auto proxies = MakeShuffledAccumulators(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    pro::invoke_batch<poly::Accumulate>(std::span{proxies}, sum);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_InvokeBatchUnordered(benchmark::State& state) {
+  auto proxies = MakeShuffledAccumulators(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    int sum = 0;
+    pro::invoke_batch_unordered<poly::Accumulate>(std::span{proxies}, sum);
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+pro::poly_vector<poly::Body> MakeBodies(std::size_t count) {
+  pro::poly_vector<poly::Body> result;
+  for (std::size_t i = 0; i < count; ++i) {
+    float f = static_cast<float>(i);
+    if (i % 4 == 0) {
+      result.emplace_back<Drifter>(f, f);
+    } else {
+      result.emplace_back<Particle>(f, f, 1.f, -1.f);
+    }
+  }
+  return result;
+}
+
+void BM_PolyVectorInvokeEach(benchmark::State& state) {
+  auto bodies = MakeBodies(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    bodies.invoke_each<poly::Step>(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PolyVectorInvokeBulk(benchmark::State& state) {
+  auto bodies = MakeBodies(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    bodies.invoke_bulk<poly::BulkStep>(0.01f);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_InvokeLoop)->Arg(1 << 17)->Arg(1 << 20);
+BENCHMARK(BM_InvokeBatch)->Arg(1 << 17)->Arg(1 << 20);
+BENCHMARK(BM_InvokeBatchUnordered)->Arg(1 << 17)->Arg(1 << 20);
+BENCHMARK(BM_PolyVectorInvokeEach)->Arg(1 << 17);
+BENCHMARK(BM_PolyVectorInvokeBulk)->Arg(1 << 17);
+
+}  // namespace
@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "proxy_executor.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Handle, int(int) noexcept);
+PRO_DEF_FACADE(Handler, Handle);
+PRO_DEF_MEMBER_DISPATCH(Weight, std::size_t() noexcept);
+PRO_DEF_FACADE(Event, Weight, pro::proxiable_ptr_constraints{
+    .max_size = 6u * sizeof(void*),
+    .max_align = alignof(void*),
+    .copyability = pro::constraint_level::none,
+    .relocatability = pro::constraint_level::nothrow,
+    .destructibility = pro::constraint_level::nothrow,
+  });
+
+}  // namespace poly
+
+class Handler {
+ public:
+  virtual ~Handler() = default;
+  virtual int Handle(int request) const noexcept = 0;
+};
+
+class Offset : public Handler {
+ public:
+  explicit Offset(int offset) noexcept : offset_(offset) {}
+  int Handle(int request) const noexcept override { return request + offset_; }
+
+ private:
+  int offset_;
+};
+
+// Every thread invokes the current handler; thread 0 also replaces it once
+// every kReloadInterval invocations
+constexpr int kReloadInterval = 1024;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+using SharedHandlerSlot = std::atomic<std::shared_ptr<const Handler>>;
+#else
+class SharedHandlerSlot {
+ public:
+  explicit SharedHandlerSlot(std::shared_ptr<const Handler> p) : p_(std::move(p)) {}
+  std::shared_ptr<const Handler> load() const {
+    std::lock_guard lock{mtx_};
+    return p_;
+  }
+  void store(std::shared_ptr<const Handler> p) {
+    std::lock_guard lock{mtx_};
+    p_.swap(p);
+  }
+
+ private:
+  mutable std::mutex mtx_;
+  std::shared_ptr<const Handler> p_;
+};
+#endif  // defined(__cpp_lib_atomic_shared_ptr)
+
+void BM_ReloadableAtomicSharedPtr(benchmark::State& state) {
+  static SharedHandlerSlot slot{std::make_shared<const Offset>(0)};
+  int request = 0, reload = 0;
+  for (auto _ : state) {
+    request = slot.load()->Handle(request);
+    if (state.thread_index() == 0 && ++reload == kReloadInterval) {
+      reload = 0;
+      slot.store(std::make_shared<const Offset>(request & 1));
+    }
+  }
+  benchmark::DoNotOptimize(request);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ReloadableAtomicProxy(benchmark::State& state) {
+  static pro::atomic_proxy<poly::Handler> slot{pro::make_proxy<poly::Handler, Offset>(0)};
+  int request = 0, reload = 0;
+  for (auto _ : state) {
+    request = slot(request);
+    if (state.thread_index() == 0 && ++reload == kReloadInterval) {
+      reload = 0;
+      slot.store(pro::make_proxy<poly::Handler, Offset>(request & 1));
+    }
+  }
+  benchmark::DoNotOptimize(request);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// A conventional pool of which workers share a single queue of std::function
+class FunctionPool {
+ public:
+  explicit FunctionPool(std::size_t thread_count) {
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads_.emplace_back([this] { Run(); });
+    }
+  }
+  ~FunctionPool() {
+    {
+      std::lock_guard lock{mtx_};
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& t : threads_) {
+      t.join();
+    }
+  }
+
+  void submit(std::function<void()> task) {
+    pending_.fetch_add(1u, std::memory_order_relaxed);
+    {
+      std::lock_guard lock{mtx_};
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+  void wait_idle() {
+    for (std::size_t pending = pending_.load(); pending != 0u; pending = pending_.load()) {
+      pending_.wait(pending);
+    }
+  }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock{mtx_};
+        cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+      if (pending_.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        pending_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::atomic<std::size_t> pending_{0u};
+  bool stopping_ = false;
+};
+
+// Each task spawns two children until the given depth, so that most tasks
+// are submitted from worker threads
+constexpr int kSpawnDepth = 14;
+
+template <class Pool>
+struct Spawn {
+  void operator()() const {
+    if (depth == 0) {
+      leaves->fetch_add(1, std::memory_order_relaxed);
+    } else {
+      pool->submit(Spawn{pool, depth - 1, leaves});
+      pool->submit(Spawn{pool, depth - 1, leaves});
+    }
+  }
+
+  Pool* pool;
+  int depth;
+  std::atomic<int>* leaves;
+};
+
+template <class Pool>
+void BM_SpawnTasks(benchmark::State& state) {
+  Pool pool{static_cast<std::size_t>(state.range(0))};
+  std::atomic<int> leaves = 0;
+  for (auto _ : state) {
+    pool.submit(Spawn<Pool>{&pool, kSpawnDepth, &leaves});
+    pool.wait_idle();
+  }
+  benchmark::DoNotOptimize(leaves.load());
+  state.SetItemsProcessed(state.iterations() * ((2 << kSpawnDepth) - 1));
+}
+
+// Same as Spawn, except that each task captures a string, which is not
+// trivially relocatable with libstdc++
+template <class Pool>
+struct LabeledSpawn {
+  void operator()() const {
+    if (depth == 0) {
+      leaves->fetch_add(static_cast<int>(label.size()), std::memory_order_relaxed);
+    } else {
+      pool->submit(LabeledSpawn{pool, depth - 1, leaves, label});
+      pool->submit(LabeledSpawn{pool, depth - 1, leaves, label});
+    }
+  }
+
+  Pool* pool;
+  int depth;
+  std::atomic<int>* leaves;
+  std::string label;
+};
+
+template <class Pool>
+void BM_SpawnCapturingTasks(benchmark::State& state) {
+  Pool pool{static_cast<std::size_t>(state.range(0))};
+  std::atomic<int> leaves = 0;
+  for (auto _ : state) {
+    pool.submit(LabeledSpawn<Pool>{&pool, kSpawnDepth, &leaves, "label"});
+    pool.wait_idle();
+  }
+  benchmark::DoNotOptimize(leaves.load());
+  state.SetItemsProcessed(state.iterations() * ((2 << kSpawnDepth) - 1));
+}
+
+// Not trivially relocatable with libstdc++, so that each relocation of a
+// proxy calls the move constructor
+class Sample {
+ public:
+  Sample(const char* source, std::size_t count) : source_(source), count_(count) {}
+  std::size_t Weight() const noexcept { return source_.size() * count_; }
+
+ private:
+  std::string source_;
+  std::size_t count_;
+};
+
+constexpr std::size_t kHandoffBatch = 64u;
+
+// The conventional handoff: a proxy is created, moved into a slot, and moved
+// out again by the consumer
+void BM_HandoffByRelocation(benchmark::State& state) {
+  std::vector<pro::proxy<poly::Event>> slots(kHandoffBatch);
+  std::size_t total = 0u;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kHandoffBatch; ++i) {
+      pro::proxy<poly::Event> p = pro::make_proxy<poly::Event, Sample>("sensor", i);
+      slots[i] = std::move(p);
+    }
+    for (std::size_t i = 0; i < kHandoffBatch; ++i) {
+      pro::proxy<poly::Event> p = std::move(slots[i]);
+      total += p.invoke<poly::Weight>();
+    }
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations() * kHandoffBatch);
+}
+
+void BM_HandoffInPlace(benchmark::State& state) {
+  pro::spsc_proxy_queue<poly::Event> queue{kHandoffBatch};
+  std::size_t total = 0u;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kHandoffBatch; ++i) {
+      queue.try_make<Sample>("sensor", i);
+    }
+    for (std::size_t i = 0; i < kHandoffBatch; ++i) {
+      queue.try_consume([&](pro::proxy<poly::Event>& p) { total += p.invoke<poly::Weight>(); });
+    }
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations() * kHandoffBatch);
+}
+
+}  // namespace
+
+BENCHMARK(BM_HandoffByRelocation);
+BENCHMARK(BM_HandoffInPlace);
+
+BENCHMARK(BM_SpawnTasks<FunctionPool>)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BM_SpawnTasks<pro::task_executor<>>)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BM_SpawnCapturingTasks<FunctionPool>)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BM_SpawnCapturingTasks<pro::task_executor<>>)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+BENCHMARK(BM_ReloadableAtomicSharedPtr)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ReloadableAtomicProxy)->ThreadRange(1, 8)->UseRealTime();
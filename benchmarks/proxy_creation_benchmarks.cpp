@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Accumulate, void(int&) noexcept);
+PRO_DEF_FACADE(Accumulable, Accumulate);
+
+}  // namespace poly
+
+// Too large for the default SBO, so that make_proxy() falls back to the heap
+class LargeAccumulator {
+ public:
+  explicit LargeAccumulator(int value) noexcept : values_{value} {}
+
+  void Accumulate(int& sum) const noexcept { sum += values_[0]; }
+
+ private:
+  int values_[16];
+};
+
+template <auto MakeProxy>
+void BM_CreateAndDestroy(benchmark::State& state) {
+  std::vector<pro::proxy<poly::Accumulable>> proxies;
+  proxies.reserve(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      proxies.push_back(MakeProxy(i));
+    }
+    int sum = 0;
+    for (const auto& p : proxies) {
+      p.invoke(sum);
+    }
+    benchmark::DoNotOptimize(sum);
+    proxies.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+pro::proxy<poly::Accumulable> MakeHeapProxy(int value)
+    { return pro::make_proxy<poly::Accumulable, LargeAccumulator>(value); }
+pro::proxy<poly::Accumulable> MakePooledProxy(int value)
+    { return pro::make_proxy_pooled<poly::Accumulable, LargeAccumulator>(value); }
+
+BENCHMARK(BM_CreateAndDestroy<MakeHeapProxy>)->Arg(1)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_CreateAndDestroy<MakePooledProxy>)->Arg(1)->Arg(1 << 10)->Arg(1 << 16);
+
+}  // namespace
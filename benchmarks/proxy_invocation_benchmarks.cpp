@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Call sites are monomorphic, polymorphic or megamorphic when the callees
+// are of 1, 2 or 8 types, respectively (sealed_proxy is always declared over
+// all 8 types). Callees with 1 int are stored in place (SBO) by proxy and the
+// standard function wrappers, while callees with 16 ints are allocated on the
+// heap (deep_ptr for proxy).
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Fun, int(int));
+PRO_DEF_MEMBER_DISPATCH(Mix, int(int, double, const std::string&, int, int, int));
+PRO_DEF_FACADE(Callee, PRO_MAKE_DISPATCH_PACK(Fun, Mix));
+PRO_DEF_FACADE(CachedCallee, PRO_MAKE_DISPATCH_PACK(Fun, Mix), pro::relocatable_ptr_constraints, void,
+    pro::facade_options{.cache_address = true});
+
+PRO_DEF_MEMBER_DISPATCH(GetKey, int() noexcept);
+PRO_DEF_FACADE(KeyedByMethod, GetKey);
+PRO_DEF_MEMBER_FIELD(key, int);
+PRO_DEF_FACADE(KeyedByField, key);
+
+}  // namespace poly
+
+// Counts the copies and moves of messages passed by value
+struct Message {
+  static inline std::size_t copies = 0u;
+  static inline std::size_t moves = 0u;
+
+  Message(std::string text, std::vector<int> data) noexcept
+      : text(std::move(text)), data(std::move(data)) {}
+  Message(const Message& rhs) : text(rhs.text), data(rhs.data) { ++copies; }
+  Message(Message&& rhs) noexcept : text(std::move(rhs.text)), data(std::move(rhs.data)) { ++moves; }
+
+  std::string text;
+  std::vector<int> data;
+};
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Post, std::size_t(Message));
+PRO_DEF_FACADE(Mailbox, Post);
+
+}  // namespace poly
+
+constexpr std::size_t kCalleeCount = 1024u;
+
+template <int I, std::size_t N>
+class Callee {
+ public:
+  explicit Callee(int value) noexcept { std::fill_n(values_, N, value); }
+
+  int Fun(int x) noexcept { return x + values_[N - 1u] + I; }
+  int Mix(int a, double b, const std::string& c, int d, int e, int f) noexcept
+      { return a + static_cast<int>(b) + static_cast<int>(c.size()) + d + e + f + values_[N - 1u] + I; }
+
+ private:
+  int values_[N];
+};
+
+class ICallee {
+ public:
+  virtual ~ICallee() = default;
+  virtual int Fun(int x) noexcept = 0;
+  virtual int Mix(int a, double b, const std::string& c, int d, int e, int f) noexcept = 0;
+};
+
+template <int I, std::size_t N>
+class VirtualCallee : public ICallee {
+ public:
+  explicit VirtualCallee(int value) noexcept : impl_(value) {}
+
+  int Fun(int x) noexcept override { return impl_.Fun(x); }
+  int Mix(int a, double b, const std::string& c, int d, int e, int f) noexcept override
+      { return impl_.Mix(a, b, c, d, e, f); }
+
+ private:
+  Callee<I, N> impl_;
+};
+
+template <std::size_t N>
+struct VirtualFactory {
+  using Callee = std::unique_ptr<ICallee>;
+
+  template <int I>
+  static Callee Make(int value) { return std::make_unique<VirtualCallee<I, N>>(value); }
+  static int Fun(Callee& c, int x) { return c->Fun(x); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c->Mix(x, 1.5, s, x, x, x); }
+};
+
+template <std::size_t N>
+struct ProxyFactory {
+  using Callee = pro::proxy<poly::Callee>;
+
+  template <int I>
+  static Callee Make(int value) { return pro::make_proxy<poly::Callee, ::Callee<I, N>>(value); }
+  static int Fun(Callee& c, int x) { return c.invoke<poly::Fun>(x); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c.invoke<poly::Mix>(x, 1.5, s, x, x, x); }
+};
+
+// Callees are shared, i.e., the address of each object is computed from the
+// address of its control block unless cached in the proxy
+template <std::size_t N, class F = poly::Callee>
+struct SharedProxyFactory {
+  using Callee = pro::proxy<F>;
+
+  template <int I>
+  static Callee Make(int value) { return pro::make_proxy_shared<F, ::Callee<I, N>>(value); }
+  static int Fun(Callee& c, int x) { return c.template invoke<poly::Fun>(x); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c.template invoke<poly::Mix>(x, 1.5, s, x, x, x); }
+};
+template <std::size_t N>
+using CachedSharedProxyFactory = SharedProxyFactory<N, poly::CachedCallee>;
+
+// Speculates on the type of the first callee, i.e., every call site hits
+// for 1 type, half of the calls hit for 2 types, and 1/8 of them for 8 types
+template <std::size_t N>
+struct LikelyProxyFactory {
+  using Callee = pro::proxy<poly::Callee>;
+  using Expected = std::unique_ptr<::Callee<0, N>>;
+
+  template <int I>
+  static Callee Make(int value) { return std::make_unique<::Callee<I, N>>(value); }
+  static int Fun(Callee& c, int x) { return c.invoke_likely<Expected, poly::Fun>(x); }
+  static int Mix(Callee& c, const std::string& s, int x)
+      { return c.invoke_likely<Expected, poly::Mix>(x, 1.5, s, x, x, x); }
+};
+
+template <std::size_t N, class Is> struct SealedCallee;
+template <std::size_t N, int... Is>
+struct SealedCallee<N, std::integer_sequence<int, Is...>>
+    : std::type_identity<pro::sealed_proxy<poly::Callee, Callee<Is, N>...>> {};
+
+template <std::size_t N>
+struct SealedFactory {
+  using Callee = typename SealedCallee<N, std::make_integer_sequence<int, 8>>::type;
+
+  template <int I>
+  static Callee Make(int value) { return Callee{std::in_place_type<::Callee<I, N>>, value}; }
+  static int Fun(Callee& c, int x) { return c.template invoke<poly::Fun>(x); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c.template invoke<poly::Mix>(x, 1.5, s, x, x, x); }
+};
+
+template <std::size_t N>
+struct StdFunctionFactory {
+  using Callee = std::function<int(int)>;
+
+  template <int I>
+  static Callee Make(int value) { return [c = ::Callee<I, N>{value}](int x) mutable { return c.Fun(x); }; }
+  static int Fun(Callee& c, int x) { return c(x); }
+};
+
+#ifdef __cpp_lib_move_only_function
+template <std::size_t N>
+struct MoveOnlyFunctionFactory {
+  using Callee = std::move_only_function<int(int)>;
+
+  template <int I>
+  static Callee Make(int value) { return [c = ::Callee<I, N>{value}](int x) mutable { return c.Fun(x); }; }
+  static int Fun(Callee& c, int x) { return c(x); }
+};
+#endif  // __cpp_lib_move_only_function
+
+// A function wrapper holds a single signature, so the callees of
+// BM_InvokeWithManyArguments are wrapped separately
+template <int I, std::size_t N>
+auto MakeMixer(int value) {
+  return [c = Callee<I, N>{value}](int a, double b, const std::string& s, int d, int e, int f) mutable { return c.Mix(a, b, s, d, e, f); };
+}
+
+template <std::size_t N>
+struct StdFunctionMixFactory {
+  using Callee = std::function<int(int, double, const std::string&, int, int, int)>;
+
+  template <int I>
+  static Callee Make(int value) { return MakeMixer<I, N>(value); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c(x, 1.5, s, x, x, x); }
+};
+
+#ifdef __cpp_lib_move_only_function
+template <std::size_t N>
+struct MoveOnlyFunctionMixFactory {
+  using Callee = std::move_only_function<int(int, double, const std::string&, int, int, int)>;
+
+  template <int I>
+  static Callee Make(int value) { return MakeMixer<I, N>(value); }
+  static int Mix(Callee& c, const std::string& s, int x) { return c(x, 1.5, s, x, x, x); }
+};
+#endif  // __cpp_lib_move_only_function
+
+template <class Factory, int TypeCount>
+std::vector<typename Factory::Callee> MakeCallees() {
+  constexpr auto kMakers = []<int... Is>(std::integer_sequence<int, Is...>) {
+    return std::array<typename Factory::Callee (*)(int), TypeCount>{&Factory::template Make<Is>...};
+  }(std::make_integer_sequence<int, TypeCount>{});
+  std::vector<typename Factory::Callee> result;
+  result.reserve(kCalleeCount);
+  for (std::size_t i = 0; i < kCalleeCount; ++i) {
+    result.push_back(kMakers[i % TypeCount](static_cast<int>(i)));
+  }
+  std::shuffle(result.begin(), result.end(), std::mt19937{42u});
+  return result;
+}
+
+template <class Factory, int TypeCount>
+void BM_Invoke(benchmark::State& state) {
+  auto callees = MakeCallees<Factory, TypeCount>();
+  for (auto _ : state) {
+    int sum = 0;
+    for (auto& c : callees) {
+      sum += Factory::Fun(c, sum);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kCalleeCount);
+}
+
+template <class Factory, int TypeCount>
+void BM_InvokeWithManyArguments(benchmark::State& state) {
+  auto callees = MakeCallees<Factory, TypeCount>();
+  std::string s = "argument";
+  for (auto _ : state) {
+    int sum = 0;
+    for (auto& c : callees) {
+      sum += Factory::Mix(c, s, sum);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kCalleeCount);
+}
+
+#define PRO_BENCHMARK_INVOCATION(FUNC, FACTORY) \
+    BENCHMARK_TEMPLATE(FUNC, FACTORY, 1); \
+    BENCHMARK_TEMPLATE(FUNC, FACTORY, 2); \
+    BENCHMARK_TEMPLATE(FUNC, FACTORY, 8)
+
+PRO_BENCHMARK_INVOCATION(BM_Invoke, VirtualFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, ProxyFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, SealedFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, StdFunctionFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, VirtualFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, ProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, LikelyProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, SharedProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, CachedSharedProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, StdFunctionFactory<16>);
+#ifdef __cpp_lib_move_only_function
+PRO_BENCHMARK_INVOCATION(BM_Invoke, MoveOnlyFunctionFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_Invoke, MoveOnlyFunctionFactory<16>);
+#endif  // __cpp_lib_move_only_function
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, VirtualFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, ProxyFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, SealedFactory<1>);
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, ProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, LikelyProxyFactory<16>);
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, StdFunctionMixFactory<1>);
+#ifdef __cpp_lib_move_only_function
+PRO_BENCHMARK_INVOCATION(BM_InvokeWithManyArguments, MoveOnlyFunctionMixFactory<1>);
+#endif  // __cpp_lib_move_only_function
+
+template <int I>
+struct Keyed {
+  int GetKey() const noexcept { return key; }
+
+  int key;
+  int payload[3] = {};
+};
+
+template <class F, class D>
+void BM_SortByKey(benchmark::State& state) {
+  constexpr auto kMakers = []<int... Is>(std::integer_sequence<int, Is...>) {
+    return std::array<pro::proxy<F> (*)(int), 8>{[](int key) { return pro::make_proxy<F, Keyed<Is>>(key); }...};
+  }(std::make_integer_sequence<int, 8>{});
+  std::vector<pro::proxy<F>> proxies;
+  std::mt19937 gen{42u};
+  for (std::size_t i = 0; i < kCalleeCount; ++i) {
+    proxies.push_back(kMakers[i % 8u](static_cast<int>(gen())));
+  }
+  std::vector<std::size_t> order(kCalleeCount);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kCalleeCount; ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+        { return proxies[a].template invoke<D>() < proxies[b].template invoke<D>(); });
+    benchmark::DoNotOptimize(order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kCalleeCount);
+}
+BENCHMARK_TEMPLATE(BM_SortByKey, poly::KeyedByMethod, poly::GetKey);
+BENCHMARK_TEMPLATE(BM_SortByKey, poly::KeyedByField, poly::key);
+
+class IMailbox {
+ public:
+  virtual ~IMailbox() = default;
+  virtual std::size_t Post(Message message) = 0;
+};
+
+class Mailbox : public IMailbox {
+ public:
+  std::size_t Post(Message message) override {
+    last_ = std::move(message.text);
+    return last_.size() + message.data.size();
+  }
+
+ private:
+  std::string last_;
+};
+
+template <class Poster>
+void MeasurePost(benchmark::State& state, Poster&& post) {
+  std::string text(64u, 'x');
+  std::vector<int> data(16u, 1);
+  Message::copies = 0u;
+  Message::moves = 0u;
+  for (auto _ : state) {
+    Message message{text, data};
+    benchmark::DoNotOptimize(post(message));
+  }
+  state.counters["copies_per_call"] = benchmark::Counter(static_cast<double>(Message::copies) / state.iterations());
+  state.counters["moves_per_call"] = benchmark::Counter(static_cast<double>(Message::moves) / state.iterations());
+}
+
+void BM_PostByValueToVirtual(benchmark::State& state) {
+  std::unique_ptr<IMailbox> mailbox = std::make_unique<Mailbox>();
+  MeasurePost(state, [&](Message& m) { return mailbox->Post(std::move(m)); });
+}
+BENCHMARK(BM_PostByValueToVirtual);
+
+void BM_PostLvalueToVirtual(benchmark::State& state) {
+  std::unique_ptr<IMailbox> mailbox = std::make_unique<Mailbox>();
+  MeasurePost(state, [&](const Message& m) { return mailbox->Post(m); });
+}
+BENCHMARK(BM_PostLvalueToVirtual);
+
+void BM_PostByValueToProxy(benchmark::State& state) {
+  pro::proxy<poly::Mailbox> mailbox = pro::make_proxy<poly::Mailbox, Mailbox>();
+  MeasurePost(state, [&](Message& m) { return mailbox.invoke<poly::Post>(std::move(m)); });
+}
+BENCHMARK(BM_PostByValueToProxy);
+
+void BM_PostLvalueToProxy(benchmark::State& state) {
+  pro::proxy<poly::Mailbox> mailbox = pro::make_proxy<poly::Mailbox, Mailbox>();
+  MeasurePost(state, [&](const Message& m) { return mailbox.invoke<poly::Post>(m); });
+}
+BENCHMARK(BM_PostLvalueToProxy);
+
+}  // namespace
@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0u};
+
+void* Allocate(std::size_t size, std::size_t alignment) noexcept {
+  allocation_count.fetch_add(1u, std::memory_order_relaxed);
+  size = size == 0u ? 1u : size;
+  if (alignment <= alignof(std::max_align_t)) {
+    return std::malloc(size);
+  }
+#ifdef _MSC_VER
+  return _aligned_malloc(size, alignment);
+#else
+  return std::aligned_alloc(alignment, (size + alignment - 1u) / alignment * alignment);
+#endif  // _MSC_VER
+}
+void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+  void* result = Allocate(size, alignment);
+  if (result == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return result;
+}
+void Deallocate(void* p, std::size_t alignment) noexcept {
+#ifdef _MSC_VER
+  if (alignment > alignof(std::max_align_t)) {
+    _aligned_free(p);
+    return;
+  }
+#endif  // _MSC_VER
+  (void)alignment;
+  std::free(p);
+}
+
+constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+}  // namespace
+
+// Counts heap allocations of the whole executable, so that benchmarks can
+// report allocations per operation. Every replaceable allocation and
+// deallocation function is replaced, so that each allocation is released by
+// the matching function
+void* operator new(std::size_t size) { return AllocateOrThrow(size, kDefaultAlignment); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, kDefaultAlignment); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, kDefaultAlignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, kDefaultAlignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete[](void* p) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete(void* p, std::size_t) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete[](void* p, std::size_t) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Deallocate(p, kDefaultAlignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { Deallocate(p, static_cast<std::size_t>(alignment)); }
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Accumulate, void(int&) noexcept);
+PRO_DEF_FACADE(CopyableAccumulable, Accumulate, pro::copyable_ptr_constraints);
+PRO_DEF_FACADE(MovableAccumulable, Accumulate);
+PRO_DEF_FACADE(TrivialAccumulable, Accumulate, pro::trivial_ptr_constraints);
+
+}  // namespace poly
+
+class Accumulator {
+ public:
+  explicit Accumulator(int value) noexcept : value_(value) {}
+
+  void Accumulate(int& sum) const noexcept { sum += value_; }
+
+ private:
+  int value_;
+};
+
+class LargeAccumulator {
+ public:
+  explicit LargeAccumulator(int value) noexcept : values_{value} {}
+
+  void Accumulate(int& sum) const noexcept { sum += values_[0]; }
+
+ private:
+  int values_[16];
+};
+
+// Note that libstdc++ does not update the reference count of shared_ptr
+// atomically until a second thread is started
+template <auto MakeProxy>
+void BM_CopyAndDestroy(benchmark::State& state) {
+  pro::proxy<poly::CopyableAccumulable> origin = MakeProxy();
+  std::vector<pro::proxy<poly::CopyableAccumulable>> copies;
+  copies.reserve(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      copies.push_back(origin);
+    }
+    benchmark::DoNotOptimize(copies.data());
+    copies.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+pro::proxy<poly::CopyableAccumulable> MakeStdSharedProxy() {
+  return pro::proxy<poly::CopyableAccumulable>{
+      std::make_shared<Accumulator>(1)};
+}
+pro::proxy<poly::CopyableAccumulable> MakeAtomicSharedProxy() {
+  return pro::make_proxy_shared<poly::CopyableAccumulable, Accumulator>(1);
+}
+pro::proxy<poly::CopyableAccumulable> MakeNonAtomicSharedProxy() {
+  return pro::make_proxy_shared<poly::CopyableAccumulable, Accumulator,
+      pro::refcount_policy::nonatomic>(1);
+}
+
+pro::proxy<poly::CopyableAccumulable> MakeDeepCopyProxy()
+    { return pro::make_proxy<poly::CopyableAccumulable, LargeAccumulator>(1); }
+pro::proxy<poly::CopyableAccumulable> MakeCowProxy()
+    { return pro::make_proxy_cow<poly::CopyableAccumulable, LargeAccumulator>(1); }
+
+BENCHMARK(BM_CopyAndDestroy<MakeStdSharedProxy>)->Arg(1 << 10);
+BENCHMARK(BM_CopyAndDestroy<MakeAtomicSharedProxy>)->Arg(1 << 10);
+BENCHMARK(BM_CopyAndDestroy<MakeNonAtomicSharedProxy>)->Arg(1 << 10);
+BENCHMARK(BM_CopyAndDestroy<MakeDeepCopyProxy>)->Arg(1 << 10);
+BENCHMARK(BM_CopyAndDestroy<MakeCowProxy>)->Arg(1 << 10);
+
+// Not known to be trivially relocatable, so that moves go through the
+// relocation dispatcher of the proxy
+class OpaqueAccumulatorPtr {
+ public:
+  explicit OpaqueAccumulatorPtr(int value)
+      : ptr_(std::make_unique<Accumulator>(value)) {}
+  OpaqueAccumulatorPtr(OpaqueAccumulatorPtr&& rhs) noexcept
+      : ptr_(std::move(rhs.ptr_)) {}
+
+  Accumulator* operator->() const noexcept { return ptr_.get(); }
+
+ private:
+  std::unique_ptr<Accumulator> ptr_;
+};
+
+template <class P>
+void BM_ReverseProxies(benchmark::State& state) {
+  std::vector<pro::proxy<poly::MovableAccumulable>> proxies;
+  for (int i = 0; i < state.range(0); ++i) {
+    if constexpr (std::is_constructible_v<P, int>) {
+      proxies.emplace_back(std::in_place_type<P>, i);
+    } else {
+      proxies.emplace_back(std::make_unique<Accumulator>(i));
+    }
+  }
+  for (auto _ : state) {
+    std::reverse(proxies.begin(), proxies.end());
+    benchmark::DoNotOptimize(proxies.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ReverseProxies<std::unique_ptr<Accumulator>>)->Arg(1 << 10);
+BENCHMARK(BM_ReverseProxies<OpaqueAccumulatorPtr>)->Arg(1 << 10);
+
+constexpr std::size_t kBatchSize = 1024u;
+
+// Measures an operation on a batch of proxies; the preparation of each batch
+// is excluded from the timings and from the allocation count
+template <class F, class Prepare, class Operate>
+void MeasureLifetimeOperation(benchmark::State& state, Prepare prepare,
+    Operate operate) {
+  std::vector<pro::proxy<F>> lhs(kBatchSize);
+  std::vector<pro::proxy<F>> rhs(kBatchSize);
+  std::size_t allocations = 0u;
+  for (auto _ : state) {
+    state.PauseTiming();
+    prepare(lhs, rhs);
+    std::size_t before = allocation_count.load(std::memory_order_relaxed);
+    state.ResumeTiming();
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      operate(lhs[i], rhs[i]);
+    }
+    benchmark::DoNotOptimize(lhs.data());
+    allocations += allocation_count.load(std::memory_order_relaxed) - before;
+  }
+  std::size_t operations = state.iterations() * kBatchSize;
+  state.SetItemsProcessed(static_cast<int64_t>(operations));
+  state.counters["allocs_per_op"] = static_cast<double>(allocations) /
+      static_cast<double>(operations);
+}
+
+template <class F, class T>
+void FillWithObjects(std::vector<pro::proxy<F>>& proxies) {
+  for (std::size_t i = 0; i < proxies.size(); ++i) {
+    proxies[i] = pro::make_proxy<F, T>(static_cast<int>(i));
+  }
+}
+
+template <class F, class T>
+void BM_Construct(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto&) {
+        for (auto& p : lhs) {
+          p.reset();
+        }
+      },
+      [](pro::proxy<F>& lhs, pro::proxy<F>&)
+          { std::construct_at(&lhs, pro::make_proxy<F, T>(1)); });
+}
+
+template <class F, class T>
+void BM_Copy(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto& rhs) {
+        for (auto& p : lhs) {
+          p.reset();
+        }
+        FillWithObjects<F, T>(rhs);
+      },
+      [](pro::proxy<F>& lhs, pro::proxy<F>& rhs)
+          { std::construct_at(&lhs, rhs); });
+}
+
+template <class F, class T>
+void BM_Move(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto& rhs) {
+        for (auto& p : lhs) {
+          p.reset();
+        }
+        FillWithObjects<F, T>(rhs);
+      },
+      [](pro::proxy<F>& lhs, pro::proxy<F>& rhs)
+          { std::construct_at(&lhs, std::move(rhs)); });
+}
+
+template <class F, class T>
+void BM_Swap(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto& rhs) {
+        if (!lhs[0].has_value()) {
+          FillWithObjects<F, T>(lhs);
+          FillWithObjects<F, T>(rhs);
+        }
+      },
+      [](pro::proxy<F>& lhs, pro::proxy<F>& rhs) { swap(lhs, rhs); });
+}
+
+// Replaces the object of each proxy with a new T, constructed in place or on
+// the heap as make_proxy would
+template <class F, class T>
+void BM_Emplace(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto&) { FillWithObjects<F, T>(lhs); },
+      [](pro::proxy<F>& lhs, pro::proxy<F>&) { lhs.template emplace<pro::details::make_proxy_ptr<F, T>>(1); });
+}
+
+template <class F, class T>
+void BM_Destroy(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto&) { FillWithObjects<F, T>(lhs); },
+      [](pro::proxy<F>& lhs, pro::proxy<F>&) {
+        std::destroy_at(&lhs);
+        std::construct_at(&lhs);  // Leaves an empty proxy for the next batch
+      });
+}
+
+template <class F, class T>
+void BM_Reset(benchmark::State& state) {
+  MeasureLifetimeOperation<F>(state,
+      [](auto& lhs, auto&) { FillWithObjects<F, T>(lhs); },
+      [](pro::proxy<F>& lhs, pro::proxy<F>&) { lhs.reset(); });
+}
+
+#define PRO_BENCHMARK_LIFETIME(FACADE, OBJECT) \
+    BENCHMARK_TEMPLATE(BM_Construct, FACADE, OBJECT); \
+    BENCHMARK_TEMPLATE(BM_Move, FACADE, OBJECT); \
+    BENCHMARK_TEMPLATE(BM_Swap, FACADE, OBJECT); \
+    BENCHMARK_TEMPLATE(BM_Emplace, FACADE, OBJECT); \
+    BENCHMARK_TEMPLATE(BM_Reset, FACADE, OBJECT); \
+    BENCHMARK_TEMPLATE(BM_Destroy, FACADE, OBJECT)
+
+PRO_BENCHMARK_LIFETIME(poly::MovableAccumulable, Accumulator);
+PRO_BENCHMARK_LIFETIME(poly::MovableAccumulable, LargeAccumulator);
+PRO_BENCHMARK_LIFETIME(poly::CopyableAccumulable, Accumulator);
+PRO_BENCHMARK_LIFETIME(poly::CopyableAccumulable, LargeAccumulator);
+PRO_BENCHMARK_LIFETIME(poly::TrivialAccumulable, Accumulator);
+BENCHMARK_TEMPLATE(BM_Copy, poly::CopyableAccumulable, Accumulator);
+BENCHMARK_TEMPLATE(BM_Copy, poly::CopyableAccumulable, LargeAccumulator);
+BENCHMARK_TEMPLATE(BM_Copy, poly::TrivialAccumulable, Accumulator);
+
+}  // namespace
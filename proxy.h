@@ -4,14 +4,32 @@
 #ifndef _MSFT_PROXY_
 #define _MSFT_PROXY_
 
+#include <atomic>
 #include <bit>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <new>
+#include <span>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
+#include <vector>
+
+#if __has_cpp_attribute(msvc::no_unique_address)
+#define ___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE msvc::no_unique_address
+#elif __has_cpp_attribute(no_unique_address)
+#define ___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE no_unique_address
+#else
+#error "Proxy requires C++20 attribute no_unique_address"
+#endif
 
 namespace pro {
 
@@ -46,6 +64,52 @@ constexpr proxiable_ptr_constraints trivial_ptr_constraints{
   .destructibility = constraint_level::trivial,
 };
 
+struct facade_options {
+  // Stores dispatchers in each proxy rather than in the shared meta table,
+  // trading one pointer per overload for one less dependent load per call.
+  // Only available to facades of one or two overloads
+  bool inline_dispatch = false;
+
+  // Places dispatchers ahead of lifetime metas and reflection in meta tables
+  bool dispatch_first = false;
+
+  // Moves lifetime metas and reflection to a separate table shared by meta
+  // tables of the same layout, leaving only dispatchers on the hot path
+  bool separate_cold_meta = false;
+
+  // Alignment of meta tables, e.g., the size of a cache line (0 keeps the
+  // natural alignment)
+  std::size_t meta_alignment = 0u;
+
+  // Caches the address of the object in each proxy, trading one pointer for
+  // resolving fancy pointers once per construction rather than once per call
+  bool cache_address = false;
+
+  // Adds an entry to meta tables with which weak_proxy observes objects
+  // created by make_proxy_shared()
+  bool weak_references = false;
+
+  // Adds an entry to meta tables with which proxy_view borrows the object of
+  // a proxy. Views of lvalues are supported regardless
+  bool proxy_views = false;
+
+  // Lets constraint_level::trivial relocatability accept pointers declared
+  // by is_trivially_relocatable, e.g., std::unique_ptr and std::shared_ptr,
+  // rather than only trivially movable and destructible ones
+  bool relocatable_by_trait = false;
+};
+
+// Specializations may declare that relocating a P (i.e., moving it and then
+// destroying the source) is equivalent to copying its bytes
+template <class P>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_move_constructible_v<P> &&
+          std::is_trivially_destructible_v<P>> {};
+template <class P>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<P>::value;
+
+template <class F> class proxy_view;
+
 namespace details {
 
 struct applicable_traits { static constexpr bool applicable = true; };
@@ -72,11 +136,12 @@ consteval bool has_copyability(constraint_level level) {
   }
 }
 template <class T>
-consteval bool has_relocatability(constraint_level level) {
+consteval bool has_relocatability(constraint_level level, bool by_trait) {
   switch (level) {
     case constraint_level::trivial:
-      return std::is_trivially_move_constructible_v<T> &&
-          std::is_trivially_destructible_v<T>;
+      return by_trait ? is_trivially_relocatable_v<T> :
+          std::is_trivially_move_constructible_v<T> &&
+              std::is_trivially_destructible_v<T>;
     case constraint_level::nothrow:
       return std::is_nothrow_move_constructible_v<T> &&
           std::is_nothrow_destructible_v<T>;
@@ -115,47 +180,253 @@ struct ptr_traits<T*> : applicable_traits {
   static auto to_address(T* p) noexcept { return p; }
   using reference_type = T&;
 };
+template <class T> class cow_ptr;
+template <class T>
+struct ptr_traits<cow_ptr<T>> : applicable_traits {
+  static const T* to_address(const cow_ptr<T>& p) noexcept
+      { return p.operator->(); }
+  static T* to_mutable_address(const cow_ptr<T>& p) { return p.unshare(); }
+  using reference_type = const T&;
+  using mutable_reference_type = T&;
+};
 
-template <class O> struct overload_traits : inapplicable_traits {};
-template <class R, class... Args>
-struct overload_traits<R(Args...)> : applicable_traits {
-  using dispatcher_type = R (*)(const char*, Args...);
-  struct resolver { R (*operator()(Args...))(Args...); };
+// Pointers with a mutable_reference_type (e.g., copy-on-write pointers) are
+// dereferenced as const unless the dispatch requires a mutable object. The
+// object is passed as an rvalue to overloads qualified with &&.
+template <class D, class P, bool RV, class... Args>
+struct dispatch_ptr_traits {
+  template <class T>
+  using qualified_type =
+      std::conditional_t<RV, std::remove_reference_t<T>&&, T>;
+
+  static constexpr bool is_mutable = requires {
+    typename ptr_traits<P>::mutable_reference_type;
+    requires !std::is_invocable_v<D,
+        qualified_type<typename ptr_traits<P>::reference_type>, Args...>;
+  };
+
+  static auto to_address(const P& p) noexcept(!is_mutable) {
+    if constexpr (is_mutable) {
+      return ptr_traits<P>::to_mutable_address(p);
+    } else {
+      return ptr_traits<P>::to_address(p);
+    }
+  }
+  using reference_type =
+      qualified_type<decltype(*to_address(std::declval<const P&>()))>;
+};
+
+// By-value arguments are passed by reference through dispatchers, so that
+// they are constructed only once when initializing the parameters of the
+// callee. Every dispatcher takes A&&: an argument of another type or value
+// category is materialized once as an A at the call site.
+template <class A, class T>
+decltype(auto) forward_argument(T&& value) {
+  if constexpr (std::is_reference_v<A> || std::is_same_v<T&&, A&&>) {
+    return std::forward<T>(value);
+  } else {
+    return A(std::forward<T>(value));
+  }
+}
+
+// Overloads qualified with && are only viable when invoking on an rvalue,
+// and are preferred over the unqualified ones in that case
+struct lvalue_call_tag {};
+struct rvalue_call_tag : lvalue_call_tag {};
+
+template <class O, class R, bool NE, bool RV, class... Args>
+struct overload_traits_impl : applicable_traits {
+  using dispatcher_type = R (*)(const char*, Args&&...) noexcept(NE);
+  struct resolver {
+    std::type_identity<O> operator()(
+        std::conditional_t<RV, rvalue_call_tag, lvalue_call_tag>, Args...);
+  };
   using forwarding_argument_types = std::tuple<Args&&...>;  // For helper macros
 
   template <class D, class P>
-  static constexpr bool applicable_ptr = std::is_invocable_v<
-      D, typename ptr_traits<P>::reference_type, Args...>;
-  static constexpr bool is_noexcept = false;
+  static constexpr bool applicable_ptr = NE ?
+      std::is_nothrow_invocable_v<D, typename dispatch_ptr_traits<
+          D, P, RV, Args...>::reference_type, Args...> &&
+          !dispatch_ptr_traits<D, P, RV, Args...>::is_mutable :
+      std::is_invocable_v<D, typename dispatch_ptr_traits<
+          D, P, RV, Args...>::reference_type, Args...>;
+  static constexpr bool is_noexcept = NE;
+  static constexpr bool is_rvalue = RV;
   template <class D, class P>
-  static R dispatcher(const char* erased, Args... args) {
-    auto ptr = ptr_traits<P>::to_address(*reinterpret_cast<const P*>(erased));
+  static R dispatcher(const char* erased, Args&&... args) noexcept(NE) {
+    using PtrTraits = dispatch_ptr_traits<D, P, RV, Args...>;
+    auto ptr = PtrTraits::to_address(*reinterpret_cast<const P*>(erased));
     if constexpr (std::is_void_v<R>) {
-      D{}(*ptr, std::forward<Args>(args)...);
+      D{}(static_cast<typename PtrTraits::reference_type>(*ptr),
+          std::forward<Args>(args)...);
     } else {
-      return D{}(*ptr, std::forward<Args>(args)...);
+      return D{}(static_cast<typename PtrTraits::reference_type>(*ptr),
+          std::forward<Args>(args)...);
     }
   }
+  template <class... CArgs>
+  static R call(dispatcher_type fn, const char* erased, CArgs&&... args) {
+    return fn(erased,
+        forward_argument<Args>(std::forward<CArgs>(args))...);
+  }
+
+  using bulk_dispatcher_type =
+      void (*)(void*, std::size_t, Args&&...) noexcept(NE);
+  template <class D, class T>
+  static constexpr bool applicable_bulk =
+      requires(std::span<T> objects, Args&&... args)
+          { D::bulk(objects, std::forward<Args>(args)...); };
+  template <class D, class T>
+  static void bulk_dispatcher(void* first, std::size_t count,
+      Args&&... args) noexcept(NE) {
+    D::bulk(std::span<T>{static_cast<T*>(first), count},
+        std::forward<Args>(args)...);
+  }
+  template <class... CArgs>
+  static void bulk_call(bulk_dispatcher_type fn, void* first,
+      std::size_t count, CArgs&&... args) {
+    fn(first, count, forward_argument<Args>(std::forward<CArgs>(args))...);
+  }
 };
+template <class O> struct overload_traits : inapplicable_traits {};
 template <class R, class... Args>
-struct overload_traits<R(Args...) noexcept> : applicable_traits {
-  using dispatcher_type = R (*)(const char*, Args...) noexcept;
-  struct resolver { R (*operator()(Args...))(Args...) noexcept; };
-  using forwarding_argument_types = std::tuple<Args&&...>;  // For helper macros
+struct overload_traits<R(Args...)>
+    : overload_traits_impl<R(Args...), R, false, false, Args...> {};
+template <class R, class... Args>
+struct overload_traits<R(Args...) noexcept>
+    : overload_traits_impl<R(Args...) noexcept, R, true, false, Args...> {};
+template <class R, class... Args>
+struct overload_traits<R(Args...) &&>
+    : overload_traits_impl<R(Args...) &&, R, false, true, Args...> {};
+template <class R, class... Args>
+struct overload_traits<R(Args...) && noexcept>
+    : overload_traits_impl<R(Args...) && noexcept, R, true, true, Args...> {};
 
+template <class O>
+struct overload_meta {
+  overload_meta() = default;
   template <class D, class P>
-  static constexpr bool applicable_ptr = std::is_nothrow_invocable_v<
-      D, typename ptr_traits<P>::reference_type, Args...>;
-  static constexpr bool is_noexcept = true;
-  template <class D, class P>
-  static R dispatcher(const char* erased, Args... args) noexcept {
-    auto ptr = ptr_traits<P>::to_address(*reinterpret_cast<const P*>(erased));
-    if constexpr (std::is_void_v<R>) {
-      D{}(*ptr, std::forward<Args>(args)...);
-    } else {
-      return D{}(*ptr, std::forward<Args>(args)...);
+  constexpr explicit overload_meta(std::in_place_type_t<D>,
+      std::in_place_type_t<P>)
+      : dispatcher(overload_traits<O>::template dispatcher<D, P>) {}
+
+  typename overload_traits<O>::dispatcher_type dispatcher;
+};
+
+// Fields of standard-layout objects are read by offset when the pointer
+// stores the object in place or holds its address in the first word
+enum class field_access : unsigned char { direct, indirect, dispatch };
+template <class P>
+struct field_address_traits
+    { static constexpr field_access access = field_access::dispatch; };
+template <class T>
+struct field_address_traits<T*> {
+  using element_type = T;
+  static constexpr field_access access = field_access::indirect;
+};
+template <class M, class V> struct is_field_of : std::false_type {};
+template <class M, class C, class V>
+struct is_field_of<M C::*, V>
+    : std::bool_constant<std::is_object_v<M> &&
+          std::is_same_v<std::remove_cv_t<M>, V>> {};
+
+template <class D>
+struct field_meta : inapplicable_traits {
+  field_meta() = default;
+  template <class P>
+  constexpr explicit field_meta(std::in_place_type_t<P>) {}
+};
+template <class D>
+    requires(std::is_same_v<typename D::overload_types,
+        std::tuple<typename D::field_type() noexcept>>)
+struct field_meta<D> : applicable_traits {
+  using field_type = typename D::field_type;
+
+  field_meta() = default;
+  template <class P>
+  constexpr explicit field_meta(std::in_place_type_t<P>)
+      : offset(0u), access(field_access::dispatch) {
+    using Traits = field_address_traits<P>;
+    if constexpr (Traits::access != field_access::dispatch) {
+      if constexpr (requires {
+          D::template offset_of<typename Traits::element_type>(); }) {
+        offset = D::template offset_of<typename Traits::element_type>();
+        access = Traits::access;
+      }
+    }
+  }
+
+  field_type read(const char* erased) const noexcept {
+    if (access == field_access::indirect) {
+      memcpy(&erased, erased, sizeof(erased));
+    }
+    return *reinterpret_cast<const field_type*>(erased + offset);
+  }
+
+  std::size_t offset;
+  field_access access;
+};
+
+// Bulk dispatches also receive a span of objects of the same type, so that a
+// run of contiguous objects is dispatched with a single call. Objects whose
+// span the dispatch does not accept are dispatched one by one
+template <class O>
+struct bulk_overload_meta {
+  bulk_overload_meta() = default;
+  template <class D, class T>
+  constexpr explicit bulk_overload_meta(std::in_place_type_t<D>,
+      std::in_place_type_t<T>)
+      : bulk_dispatcher(nullptr) {
+    if constexpr (overload_traits<O>::template applicable_bulk<D, T>) {
+      bulk_dispatcher = &overload_traits<O>::template bulk_dispatcher<D, T>;
+    }
+  }
+
+  typename overload_traits<O>::bulk_dispatcher_type bulk_dispatcher;
+};
+template <class D, class Os>
+struct bulk_meta {
+  static constexpr bool applicable = false;
+
+  bulk_meta() = default;
+  template <class P>
+  constexpr explicit bulk_meta(std::in_place_type_t<P>) {}
+};
+template <class D, class... Os> requires(D::is_bulk_dispatch)
+struct bulk_meta<D, std::tuple<Os...>> : bulk_overload_meta<Os>... {
+  static constexpr bool applicable = true;
+
+  bulk_meta() = default;
+  template <class P>
+  constexpr explicit bulk_meta(std::in_place_type_t<P>)
+      : bulk_overload_meta<Os>(std::in_place_type<D>,
+            std::in_place_type<element_type<P>>)...,
+        run_accessor(&get_run<P>) {}
+
+  template <class P>
+  using element_type =
+      std::remove_reference_t<typename ptr_traits<P>::reference_type>;
+  // Stores the address of the object of the pointer at erased, and returns
+  // how many of the count pointers of type P, stride bytes apart from there,
+  // refer to consecutive objects
+  template <class P>
+  static std::size_t get_run(const char* erased, std::size_t stride,
+      std::size_t count, void** first) noexcept {
+    auto address = [&](std::size_t i) {
+      return ptr_traits<P>::to_address(
+          *reinterpret_cast<const P*>(erased + i * stride));
+    };
+    auto head = address(0u);
+    *first = const_cast<void*>(static_cast<const void*>(head));
+    std::size_t result = 1u;
+    while (result < count && address(result) == head + result) {
+      ++result;
     }
+    return result;
   }
+
+  std::size_t (*run_accessor)(const char*, std::size_t, std::size_t, void**)
+      noexcept;
 };
 
 template <class D, class Os>
@@ -168,16 +439,20 @@ struct dispatch_traits_impl<D, std::tuple<Os...>> : applicable_traits {
       { using overload_traits<Os>::resolver::operator()...; };
 
  public:
-  struct meta {
+  using bulk = bulk_meta<D, std::tuple<Os...>>;
+  struct meta : overload_meta<Os>..., field_meta<D>, bulk {
+    meta() = default;
     template <class P>
     constexpr explicit meta(std::in_place_type_t<P>)
-        : dispatchers(overload_traits<Os>::template dispatcher<D, P>...) {}
-
-    std::tuple<typename overload_traits<Os>::dispatcher_type...> dispatchers;
+        : overload_meta<Os>(std::in_place_type<D>, std::in_place_type<P>)...,
+          field_meta<D>(std::in_place_type<P>), bulk(std::in_place_type<P>) {}
   };
   template <class... Args>
-  using matched_overload =
-      std::remove_pointer_t<std::invoke_result_t<overload_resolver, Args...>>;
+  using matched_overload = typename std::invoke_result_t<
+      overload_resolver, lvalue_call_tag, Args...>::type;
+  template <class... Args>
+  using rvalue_matched_overload = typename std::invoke_result_t<
+      overload_resolver, rvalue_call_tag, Args...>::type;
 
   template <class P>
   static constexpr bool applicable_ptr =
@@ -190,8 +465,23 @@ template <class D>
 struct dispatch_traits<D>
     : dispatch_traits_impl<D, typename D::overload_types> {};
 
+template <class D, class O, class... Args>
+decltype(auto) invoke_dispatch(const typename dispatch_traits<D>::meta& meta,
+    const char* erased, Args&&... args) {
+  if constexpr (field_meta<D>::applicable) {
+    const field_meta<D>& fm = meta;
+    if (fm.access != field_access::dispatch) {
+      return fm.read(erased);
+    }
+  }
+  return overload_traits<O>::call(
+      static_cast<const overload_meta<O>&>(meta).dispatcher, erased,
+      std::forward<Args>(args)...);
+}
+
 template <class... Ms>
 struct composite_meta : Ms... {
+  composite_meta() = default;
   template <class P>
   constexpr explicit composite_meta(std::in_place_type_t<P>)
       : Ms(std::in_place_type<P>)... {}
@@ -249,6 +539,93 @@ struct lifetime_meta_impl {
 template <template <constraint_level> class MP, constraint_level C>
 using lifetime_meta = std::conditional_t<
     requires_lifetime_meta(C), lifetime_meta_impl<MP, C>, void>;
+// A null dispatcher indicates that the bytes of P can be copied instead
+template <constraint_level C>
+struct relocatability_meta_impl {
+  template <class P>
+  constexpr explicit relocatability_meta_impl(std::in_place_type_t<P>)
+      : dispatcher(is_trivially_relocatable_v<P> ? nullptr :
+            &relocatability_meta_provider<C>::template dispatcher<P>) {}
+
+  decltype(&relocatability_meta_provider<C>::template dispatcher<void>)
+      dispatcher;
+};
+
+// Pointers of which the address of the object is cached are dispatched as
+// plain pointers to the object
+template <class P>
+using cached_address_t = std::add_pointer_t<
+    std::remove_reference_t<typename ptr_traits<P>::reference_type>>;
+template <class M>
+struct cached_address_meta : M {
+  cached_address_meta() = default;
+  template <class P>
+  constexpr explicit cached_address_meta(std::in_place_type_t<P>)
+      : M(std::in_place_type<cached_address_t<P>>) {}
+};
+struct address_meta {
+  template <class P>
+  constexpr explicit address_meta(std::in_place_type_t<P>)
+      : address_accessor(&get_address<P>) {}
+
+  template <class P>
+  static void get_address(char* address, const char* erased) noexcept {
+    new(address) cached_address_t<P>(ptr_traits<P>::to_address(
+        *reinterpret_cast<const P*>(erased)));
+  }
+
+  void (*address_accessor)(char*, const char*) noexcept;
+};
+template <bool CACHE> struct cached_address {};
+template <>
+struct cached_address<true> { alignas(void*) char value[sizeof(void*)]; };
+
+// Storage of proxies, which is empty when the facade declares no storage and
+// only empty, trivially destructible pointers are proxiable
+template <std::size_t SIZE, std::size_t ALIGN>
+struct proxy_storage {
+  operator char*() noexcept { return value; }
+  operator const char*() const noexcept { return value; }
+
+  alignas(ALIGN) char value[SIZE];
+};
+template <std::size_t ALIGN>
+struct alignas(ALIGN) proxy_storage<0u, ALIGN> {
+  operator char*() noexcept { return reinterpret_cast<char*>(this); }
+  operator const char*() const noexcept
+      { return reinterpret_cast<const char*>(this); }
+};
+// Bytes in which copies and relocations of pointers of proxies without
+// storage are constructed and discarded
+template <std::size_t ALIGN>
+struct proxy_scratch { alignas(ALIGN) char value[ALIGN]; };
+
+template <class F>
+struct view_meta_accessor {
+  view_meta_accessor() = default;
+  template <class P>
+  constexpr explicit view_meta_accessor(std::in_place_type_t<P>)
+      : view_accessor(&get_view<P>) {}
+
+  template <class P>
+  static proxy_view<F> get_view(const char* erased);
+
+  proxy_view<F> (*view_accessor)(const char*);
+};
+
+// Null unless P supports weak references, see weak_proxy
+template <class F> struct weak_ops;
+template <class F, class P>
+inline constexpr const weak_ops<F>* weak_ops_of = nullptr;
+template <class F>
+struct weak_meta_accessor {
+  weak_meta_accessor() = default;
+  template <class P>
+  constexpr explicit weak_meta_accessor(std::in_place_type_t<P>)
+      : weak(weak_ops_of<F, P>) {}
+
+  const weak_ops<F>* weak;
+};
 
 template <class O, class I>
 struct facade_meta_reduction : std::type_identity<O> {};
@@ -256,6 +633,27 @@ template <class... Ms, class I> requires(!std::is_void_v<I>)
 struct facade_meta_reduction<composite_meta<Ms...>, I>
     : std::type_identity<composite_meta<Ms..., I>> {};
 
+template <class M, class P>
+inline constexpr M cold_meta_storage{std::in_place_type<P>};
+template <class M>
+struct cold_meta_ref {
+  cold_meta_ref() = default;
+  template <class P>
+  constexpr explicit cold_meta_ref(std::in_place_type_t<P>)
+      : cold(&cold_meta_storage<M, P>) {}
+
+  const M* cold;
+};
+
+template <class F>
+consteval facade_options get_facade_options() {
+  if constexpr (requires { F::options; }) {
+    return F::options;
+  } else {
+    return facade_options{};
+  }
+}
+
 template <class... Ds>
 struct default_dispatch_traits { using default_dispatch = void; };
 template <class D>
@@ -267,13 +665,32 @@ struct basic_facade_traits_impl<F, std::tuple<Ds...>>
     : applicable_traits, default_dispatch_traits<Ds...> {
   using copyability_meta = lifetime_meta<
       copyability_meta_provider, F::constraints.copyability>;
-  using relocatability_meta = lifetime_meta<
-      relocatability_meta_provider, F::constraints.relocatability>;
+  using relocatability_meta = std::conditional_t<
+      requires_lifetime_meta(F::constraints.relocatability),
+      relocatability_meta_impl<F::constraints.relocatability>, void>;
   using destructibility_meta = lifetime_meta<
       destructibility_meta_provider, F::constraints.destructibility>;
-  using meta = recursive_reduction_t<facade_meta_reduction,
+  using cold_meta = recursive_reduction_t<facade_meta_reduction,
       composite_meta<>, copyability_meta, relocatability_meta,
-      destructibility_meta, typename F::reflection_type>;
+      destructibility_meta,
+      std::conditional_t<get_facade_options<F>().proxy_views,
+          view_meta_accessor<F>, void>,
+      std::conditional_t<get_facade_options<F>().cache_address,
+          address_meta, void>,
+      std::conditional_t<get_facade_options<F>().weak_references,
+          weak_meta_accessor<F>, void>,
+      typename F::reflection_type>;
+  static constexpr facade_options options = get_facade_options<F>();
+  using meta = std::conditional_t<options.separate_cold_meta,
+      cold_meta_ref<cold_meta>, cold_meta>;
+
+  static constexpr const cold_meta& get_cold_meta(const meta& m) noexcept {
+    if constexpr (options.separate_cold_meta) {
+      return *m.cold;
+    } else {
+      return m;
+    }
+  }
 
   template <class D>
   static constexpr bool has_dispatch = (std::is_same_v<D, Ds> || ...);
@@ -290,6 +707,10 @@ template <class F>
             const proxiable_ptr_constraints> &&
         std::has_single_bit(F::constraints.max_align) &&
         F::constraints.max_size % F::constraints.max_align == 0u &&
+        (!requires { F::options; } ||
+            (std::is_same_v<decltype(F::options), const facade_options> &&
+                (F::options.meta_alignment == 0u ||
+                    std::has_single_bit(F::options.meta_alignment)))) &&
         (std::is_void_v<typename F::reflection_type> ||
             std::is_trivially_copyable_v<typename F::reflection_type>))
 struct basic_facade_traits<F>
@@ -299,24 +720,90 @@ template <class F, class Ds>
 struct facade_traits_impl : inapplicable_traits {};
 template <class F, class... Ds> requires(dispatch_traits<Ds>::applicable && ...)
 struct facade_traits_impl<F, std::tuple<Ds...>> : applicable_traits {
-  using meta = composite_meta<typename basic_facade_traits<F>::meta,
-      typename dispatch_traits<Ds>::meta...>;
+ private:
+  static constexpr bool CacheAddress =
+      basic_facade_traits<F>::options.cache_address;
+  template <class D>
+  using hot_meta = std::conditional_t<CacheAddress,
+      cached_address_meta<typename dispatch_traits<D>::meta>,
+      typename dispatch_traits<D>::meta>;
+
+ public:
+  using dispatch_meta = composite_meta<typename dispatch_traits<Ds>::meta...>;
+  using meta = std::conditional_t<
+      basic_facade_traits<F>::options.inline_dispatch,
+      composite_meta<typename basic_facade_traits<F>::meta>,
+      std::conditional_t<basic_facade_traits<F>::options.dispatch_first ||
+              basic_facade_traits<F>::options.separate_cold_meta,
+          composite_meta<hot_meta<Ds>...,
+              typename basic_facade_traits<F>::meta>,
+          composite_meta<typename basic_facade_traits<F>::meta,
+              hot_meta<Ds>...>>>;
 
+  template <class P>
+  static constexpr bool applicable_dispatch_ptr =
+      (dispatch_traits<Ds>::template applicable_ptr<P> && ...);
+  template <class P>
+  static consteval bool applicable_dispatch_storage() {
+    if constexpr (!CacheAddress) {
+      return applicable_dispatch_ptr<P>;
+    } else if constexpr (requires { typename cached_address_t<P>; }) {
+      return applicable_dispatch_ptr<cached_address_t<P>>;
+    } else {
+      return false;
+    }
+  }
   template <class P>
   static constexpr bool applicable_ptr =
-      sizeof(P) <= F::constraints.max_size &&
+      (sizeof(P) <= F::constraints.max_size || (std::is_empty_v<P> &&
+          std::is_trivially_destructible_v<P>)) &&
       alignof(P) <= F::constraints.max_align &&
       has_copyability<P>(F::constraints.copyability) &&
-      has_relocatability<P>(F::constraints.relocatability) &&
+      has_relocatability<P>(F::constraints.relocatability,
+          basic_facade_traits<F>::options.relocatable_by_trait) &&
       has_destructibility<P>(F::constraints.destructibility) &&
-      (dispatch_traits<Ds>::template applicable_ptr<P> && ...) &&
+      applicable_dispatch_storage<P>() &&
       (std::is_void_v<typename F::reflection_type> || std::is_constructible_v<
           typename F::reflection_type, std::in_place_type_t<P>>);
-  template <class P> static constexpr meta meta_storage{std::in_place_type<P>};
+  static constexpr std::size_t meta_alignment =
+      alignof(meta) > basic_facade_traits<F>::options.meta_alignment ?
+      alignof(meta) : basic_facade_traits<F>::options.meta_alignment;
+  template <class P>
+  alignas(meta_alignment) static constexpr meta meta_storage{
+      std::in_place_type<P>};
 };
 template <class F>
 struct facade_traits : facade_traits_impl<F, typename F::dispatch_types> {};
 
+template <class F, class T>
+inline constexpr typename facade_traits<F>::dispatch_meta view_meta_storage{
+    std::in_place_type<T*>};
+
+template <class Ds> struct overload_count;
+template <class... Ds>
+struct overload_count<std::tuple<Ds...>>
+    : std::integral_constant<std::size_t,
+          (std::tuple_size_v<typename Ds::overload_types> + ... + 0u)> {};
+
+template <class F, bool INLINE>
+struct inline_meta_traits : std::type_identity<composite_meta<>> {};
+template <class F>
+struct inline_meta_traits<F, true>
+    : std::type_identity<typename facade_traits<F>::dispatch_meta> {
+  // Every proxy stores one dispatcher per overload, which only pays off for a
+  // facade of one or two overloads
+  static_assert(overload_count<typename F::dispatch_types>::value >= 1u &&
+      overload_count<typename F::dispatch_types>::value <= 2u,
+      "inline_dispatch requires a facade of one or two overloads");
+};
+
+template <class F> struct proxy_helper;
+
+template <class E> struct likely_types : std::type_identity<std::tuple<E>> {};
+template <class... Ps>
+struct likely_types<std::tuple<Ps...>>
+    : std::type_identity<std::tuple<Ps...>> {};
+
 }  // namespace details
 
 template <class F>
@@ -329,14 +816,25 @@ template <class P, class F>
 concept proxiable = facade<F> && details::ptr_traits<P>::applicable &&
     details::facade_traits<F>::template applicable_ptr<P>;
 
+// Hit and miss counts of invoke_likely, updated with relaxed atomics
+struct likely_counter {
+  std::atomic<std::size_t> hits{0u};
+  std::atomic<std::size_t> misses{0u};
+};
+
 template <basic_facade F>
 class proxy {
   using BasicTraits = details::basic_facade_traits<F>;
   using Traits = details::facade_traits<F>;
   using DefaultDispatch = typename BasicTraits::default_dispatch;
+  using InlineMeta = typename details::inline_meta_traits<
+      F, BasicTraits::options.inline_dispatch>::type;
   template <class D, class... Args>
   using MatchedOverload =
       typename details::dispatch_traits<D>::template matched_overload<Args...>;
+  template <class D, class... Args>
+  using RvalueMatchedOverload = typename details::dispatch_traits<D>
+      ::template rvalue_matched_overload<Args...>;
 
   template <class P, class... Args>
   static constexpr bool HasNothrowPolyConstructor = std::conditional_t<
@@ -347,7 +845,8 @@ class proxy {
       proxiable<P, F>, std::is_constructible<P, Args...>,
           std::false_type>::value;
   static constexpr bool HasTrivialCopyConstructor =
-      F::constraints.copyability == constraint_level::trivial;
+      F::constraints.copyability == constraint_level::trivial &&
+      !BasicTraits::options.cache_address;
   static constexpr bool HasNothrowCopyConstructor =
       F::constraints.copyability >= constraint_level::nothrow;
   static constexpr bool HasCopyConstructor =
@@ -380,15 +879,40 @@ class proxy {
   template <class D, class... Args>
   static constexpr bool HasNothrowInvocation =
       details::overload_traits<MatchedOverload<D, Args...>>::is_noexcept;
+  template <class D, class... Args>
+  static constexpr bool HasNothrowRvalueInvocation = details::overload_traits<
+      RvalueMatchedOverload<D, Args...>>::is_noexcept;
+  template <class E, class D, class... Args>
+  static constexpr bool HasLikelyInvocation = facade<F> &&
+      BasicTraits::template has_dispatch<D> &&
+      requires { typename MatchedOverload<D, Args...>; } &&
+      []<class... Ps>(std::in_place_type_t<std::tuple<Ps...>>)
+          { return (proxiable<Ps, F> && ...); }(
+          std::in_place_type<typename details::likely_types<E>::type>);
 
  public:
-  proxy() noexcept { meta_ = nullptr; }
+  proxy() noexcept {
+    meta_ = nullptr;
+    inline_meta_ = InlineMeta{};
+  }
   proxy(std::nullptr_t) noexcept : proxy() {}
   proxy(const proxy& rhs) noexcept(HasNothrowCopyConstructor)
       requires(!HasTrivialCopyConstructor && HasCopyConstructor) {
     if (rhs.meta_ != nullptr) {
-      rhs.meta_->BasicTraits::copyability_meta::dispatcher(ptr_, rhs.ptr_);
+      if constexpr (F::constraints.copyability == constraint_level::trivial) {
+        memcpy(ptr_, rhs.ptr_, F::constraints.max_size);
+      } else if constexpr (F::constraints.max_size == 0u) {
+        // See initialize()
+        details::proxy_scratch<F::constraints.max_align> temp;
+        rhs.cold_meta().BasicTraits::copyability_meta::dispatcher(
+            temp.value, rhs.ptr_);
+      } else {
+        rhs.cold_meta().BasicTraits::copyability_meta::dispatcher(
+            ptr_, rhs.ptr_);
+      }
       meta_ = rhs.meta_;
+      inline_meta_ = rhs.inline_meta_;
+      update_address();
     } else {
       meta_ = nullptr;
     }
@@ -402,9 +926,21 @@ class proxy {
           constraint_level::trivial) {
         memcpy(ptr_, rhs.ptr_, F::constraints.max_size);
       } else {
-        rhs.meta_->BasicTraits::relocatability_meta::dispatcher(ptr_, rhs.ptr_);
+        auto dispatcher =
+            rhs.cold_meta().BasicTraits::relocatability_meta::dispatcher;
+        if (dispatcher == nullptr) {
+          memcpy(ptr_, rhs.ptr_, F::constraints.max_size);
+        } else if constexpr (F::constraints.max_size == 0u) {
+          // See initialize()
+          details::proxy_scratch<F::constraints.max_align> temp;
+          dispatcher(temp.value, rhs.ptr_);
+        } else {
+          dispatcher(ptr_, rhs.ptr_);
+        }
       }
       meta_ = rhs.meta_;
+      inline_meta_ = rhs.inline_meta_;
+      update_address();
       rhs.meta_ = nullptr;
     } else {
       meta_ = nullptr;
@@ -474,7 +1010,7 @@ class proxy {
   ~proxy() noexcept(HasNothrowDestructor)
       requires(!HasTrivialDestructor && HasDestructor) {
     if (meta_ != nullptr) {
-      meta_->BasicTraits::destructibility_meta::dispatcher(ptr_);
+      cold_meta().BasicTraits::destructibility_meta::dispatcher(ptr_);
     }
   }
   ~proxy() requires(HasTrivialDestructor) = default;
@@ -483,14 +1019,52 @@ class proxy {
   bool has_value() const noexcept { return meta_ != nullptr; }
   decltype(auto) reflect() const noexcept
       requires(!std::is_void_v<typename F::reflection_type>)
-      { return static_cast<const typename F::reflection_type&>(*meta_); }
+      { return static_cast<const typename F::reflection_type&>(cold_meta()); }
   void reset() noexcept(HasNothrowDestructor) requires(HasDestructor)
       { this->~proxy(); meta_ = nullptr; }
+  template <class P>
+  bool has_type() const noexcept requires(proxiable<P, F>)
+      { return meta_ == &Traits::template meta_storage<P>; }
+  template <class P>
+  P* target() noexcept requires(proxiable<P, F>) {
+    return has_type<P>() ?
+        reinterpret_cast<P*>(static_cast<char*>(ptr_)) : nullptr;
+  }
+  template <class P>
+  const P* target() const noexcept requires(proxiable<P, F>) {
+    return has_type<P>() ?
+        reinterpret_cast<const P*>(static_cast<const char*>(ptr_)) : nullptr;
+  }
   void swap(proxy& rhs) noexcept(HasNothrowMoveConstructor)
       requires(HasMoveConstructor) {
-    if constexpr (F::constraints.relocatability == constraint_level::trivial) {
+    if (relocates_trivially() && rhs.relocates_trivially()) {
+      if (this == &rhs) {
+        return;
+      }
+      // Only the storage of nonempty proxies is initialized
+      if constexpr (F::constraints.max_size > 0u) {
+        if (meta_ != nullptr && rhs.meta_ != nullptr) {
+          alignas(F::constraints.max_align)
+              char temp[F::constraints.max_size];
+          memcpy(temp, ptr_, F::constraints.max_size);
+          memcpy(ptr_, rhs.ptr_, F::constraints.max_size);
+          memcpy(rhs.ptr_, temp, F::constraints.max_size);
+        } else if (meta_ != nullptr) {
+          memcpy(rhs.ptr_, ptr_, F::constraints.max_size);
+        } else if (rhs.meta_ != nullptr) {
+          memcpy(ptr_, rhs.ptr_, F::constraints.max_size);
+        }
+      }
       std::swap(meta_, rhs.meta_);
-      std::swap(ptr_, rhs.ptr);
+      std::swap(inline_meta_, rhs.inline_meta_);
+      update_address();
+      rhs.update_address();
+    } else if (this == &rhs) {
+      // Moves the object out and back, as swapping distinct proxies would
+      if (meta_ != nullptr) {
+        proxy temp = std::move(*this);
+        new(this) proxy(std::move(temp));
+      }
     } else {
       if (meta_ != nullptr) {
         if (rhs.meta_ != nullptr) {
@@ -512,7 +1086,7 @@ class proxy {
       requires(HasPolyAssignment<P, Args...>) {
     reset();
     initialize<P>(std::forward<Args>(args)...);
-    return *reinterpret_cast<P*>(ptr_);
+    return *reinterpret_cast<P*>(static_cast<char*>(ptr_));
   }
   template <class P, class U, class... Args>
   P& emplace(std::initializer_list<U> il, Args&&... args)
@@ -520,83 +1094,935 @@ class proxy {
       requires(HasPolyAssignment<P, std::initializer_list<U>&, Args...>) {
     reset();
     initialize<P>(il, std::forward<Args>(args)...);
-    return *reinterpret_cast<P*>(ptr_);
+    return *reinterpret_cast<P*>(static_cast<char*>(ptr_));
   }
   template <class D = DefaultDispatch, class... Args>
-  decltype(auto) invoke(Args&&... args) const
+  decltype(auto) invoke(Args&&... args) const&
       noexcept(HasNothrowInvocation<D, Args...>)
       requires(facade<F> && BasicTraits::template has_dispatch<D> &&
           requires { typename MatchedOverload<D, Args...>; }) {
-    using dispatcher_type = typename details::overload_traits<
-        MatchedOverload<D, Args...>>::dispatcher_type;
-    const auto& dispatchers = static_cast<const typename Traits::meta*>(meta_)
-        ->details::template dispatch_traits<D>::meta::dispatchers;
-    auto dispatcher = std::get<dispatcher_type>(dispatchers);
-    return dispatcher(ptr_, std::forward<Args>(args)...);
+    return details::invoke_dispatch<D, MatchedOverload<D, Args...>>(
+        get_dispatch_meta<D>(), dispatch_ptr(), std::forward<Args>(args)...);
+  }
+  // Overloads qualified with && may move from the object, which is left in
+  // the proxy afterwards
+  template <class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke(Args&&... args) &&
+      noexcept(HasNothrowRvalueInvocation<D, Args...>)
+      requires(facade<F> && BasicTraits::template has_dispatch<D> &&
+          requires { typename RvalueMatchedOverload<D, Args...>; }) {
+    return details::invoke_dispatch<D, RvalueMatchedOverload<D, Args...>>(
+        get_dispatch_meta<D>(), dispatch_ptr(), std::forward<Args>(args)...);
   }
   template <class... Args>
-  decltype(auto) operator()(Args&&... args) const
+  decltype(auto) operator()(Args&&... args) const&
       noexcept(HasNothrowInvocation<DefaultDispatch, Args...>)
       requires(facade<F> &&
           requires { typename MatchedOverload<DefaultDispatch, Args...>; })
       { return invoke(std::forward<Args>(args)...); }
+  template <class... Args>
+  decltype(auto) operator()(Args&&... args) &&
+      noexcept(HasNothrowRvalueInvocation<DefaultDispatch, Args...>)
+      requires(facade<F> && requires {
+          typename RvalueMatchedOverload<DefaultDispatch, Args...>; })
+      { return std::move(*this).invoke(std::forward<Args>(args)...); }
+  // E is either the expected pointer type or a tuple of them. When the
+  // proxy holds one of them, D is called directly without the indirection.
+  template <class E, class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke_likely(Args&&... args) const
+      noexcept(HasNothrowInvocation<D, Args...>)
+      requires(HasLikelyInvocation<E, D, Args...>) {
+    return invoke_likely_impl<D, MatchedOverload<D, Args...>>(
+        std::in_place_type<typename details::likely_types<E>::type>, nullptr,
+        std::forward<Args>(args)...);
+  }
+  template <class E, class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke_likely(likely_counter& counter, Args&&... args) const
+      noexcept(HasNothrowInvocation<D, Args...>)
+      requires(HasLikelyInvocation<E, D, Args...>) {
+    return invoke_likely_impl<D, MatchedOverload<D, Args...>>(
+        std::in_place_type<typename details::likely_types<E>::type>, &counter,
+        std::forward<Args>(args)...);
+  }
 
  private:
+  friend struct details::proxy_helper<F>;
+
+  const typename BasicTraits::cold_meta& cold_meta() const noexcept
+      { return BasicTraits::get_cold_meta(*meta_); }
+  bool relocates_trivially() const noexcept {
+    if constexpr (F::constraints.relocatability == constraint_level::trivial) {
+      return true;
+    } else {
+      return meta_ == nullptr ||
+          cold_meta().BasicTraits::relocatability_meta::dispatcher == nullptr;
+    }
+  }
+  template <class D>
+  const typename details::dispatch_traits<D>::meta& get_dispatch_meta()
+      const noexcept {
+    if constexpr (BasicTraits::options.inline_dispatch) {
+      return inline_meta_;
+    } else {
+      return *static_cast<const typename Traits::meta*>(meta_);
+    }
+  }
+  template <class D, class O>
+  typename details::overload_traits<O>::dispatcher_type get_dispatcher()
+      const noexcept {
+    return static_cast<const details::overload_meta<O>&>(
+        get_dispatch_meta<D>()).dispatcher;
+  }
+  template <class D, class O, class P, class... Ps, class... Args>
+  decltype(auto) invoke_likely_impl(std::in_place_type_t<std::tuple<P, Ps...>>,
+      likely_counter* counter, Args&&... args) const {
+    if (meta_ == &Traits::template meta_storage<P>) {
+      if (counter != nullptr) {
+        counter->hits.fetch_add(1u, std::memory_order_relaxed);
+      }
+      return details::overload_traits<O>::call(
+          &details::overload_traits<O>::template dispatcher<D, P>, ptr_,
+          std::forward<Args>(args)...);
+    }
+    if constexpr (sizeof...(Ps) > 0u) {
+      return invoke_likely_impl<D, O>(std::in_place_type<std::tuple<Ps...>>,
+          counter, std::forward<Args>(args)...);
+    } else {
+      if (counter != nullptr) {
+        counter->misses.fetch_add(1u, std::memory_order_relaxed);
+      }
+      return details::overload_traits<O>::call(get_dispatcher<D, O>(),
+          dispatch_ptr(), std::forward<Args>(args)...);
+    }
+  }
   template <class P, class... Args>
   void initialize(Args&&... args) {
-    new(ptr_) P(std::forward<Args>(args)...);
+    if constexpr (F::constraints.max_size == 0u) {
+      // The storage has no bytes of its own and may share its address with
+      // other members, so P is only constructed as a temporary. Being empty
+      // and trivially destructible, it holds no state that would be lost
+      static_assert(std::is_empty_v<P> && std::is_trivially_destructible_v<P>);
+      static_cast<void>(P(std::forward<Args>(args)...));
+    } else {
+      new(ptr_) P(std::forward<Args>(args)...);
+    }
     meta_ = &Traits::template meta_storage<P>;
+    if constexpr (BasicTraits::options.cache_address) {
+      details::address_meta::get_address<P>(address_.value, ptr_);
+      if constexpr (BasicTraits::options.inline_dispatch) {
+        inline_meta_ =
+            InlineMeta{std::in_place_type<details::cached_address_t<P>>};
+      }
+    } else if constexpr (BasicTraits::options.inline_dispatch) {
+      inline_meta_ = InlineMeta{std::in_place_type<P>};
+    }
+  }
+  void update_address() noexcept {
+    if constexpr (BasicTraits::options.cache_address) {
+      if (meta_ != nullptr) {
+        cold_meta().address_accessor(address_.value, ptr_);
+      }
+    }
+  }
+  const char* dispatch_ptr() const noexcept {
+    if constexpr (BasicTraits::options.cache_address) {
+      return address_.value;
+    } else {
+      return ptr_;
+    }
   }
 
   const typename BasicTraits::meta* meta_;
-  alignas(F::constraints.max_align) char ptr_[F::constraints.max_size];
+  [[___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE]] InlineMeta inline_meta_;
+  [[___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE]]
+  details::cached_address<BasicTraits::options.cache_address> address_;
+  [[___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE]] details::proxy_storage<
+      F::constraints.max_size, F::constraints.max_align> ptr_;
 };
 
-namespace details {
+class bad_proxy_cast : public std::bad_cast {
+ public:
+  const char* what() const noexcept override { return "pro::bad_proxy_cast"; }
+};
 
-template <class T>
-class sbo_ptr {
+// Thrown when invoking an empty sealed_proxy
+class bad_proxy_invocation : public std::exception {
  public:
-  template <class... Args>
-  sbo_ptr(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
-      requires(std::is_constructible_v<T, Args...>)
-      : value_(std::forward<Args>(args)...) {}
-  sbo_ptr(const sbo_ptr&) noexcept(std::is_nothrow_copy_constructible_v<T>)
-      = default;
-  sbo_ptr(sbo_ptr&&) noexcept(std::is_nothrow_move_constructible_v<T>)
-      = default;
+  const char* what() const noexcept override
+      { return "pro::bad_proxy_invocation"; }
+};
 
-  T* operator->() const noexcept { return &value_; }
+template <class P, class F>
+P proxy_cast(proxy<F>&& p)
+    requires(proxiable<P, F> && std::is_move_constructible_v<P> &&
+        requires { p.reset(); }) {
+  P* ptr = p.template target<P>();
+  if (ptr == nullptr) {
+    throw bad_proxy_cast{};
+  }
+  P result = std::move(*ptr);
+  p.reset();
+  return result;
+}
 
- private:
-  mutable T value_;
-};
+// A non-owning view of the object of a proxy or of an lvalue, consisting of
+// a raw pointer to the object and dispatchers that are shared among all
+// pointer types to the same object type. Dispatches with a copy-on-write
+// proxy clone its object when the view is created, if it is shared
+template <class F>
+class proxy_view {
+  using Traits = details::facade_traits<F>;
+  using DefaultDispatch = typename details::basic_facade_traits<F>
+      ::default_dispatch;
+  template <class D, class... Args>
+  using MatchedOverload =
+      typename details::dispatch_traits<D>::template matched_overload<Args...>;
 
-template <class T>
-class deep_ptr {
  public:
-  template <class... Args>
-  deep_ptr(Args&&... args) requires(std::is_constructible_v<T, Args...>)
-      : ptr_(new T(std::forward<Args>(args)...)) {}
-  deep_ptr(const deep_ptr& rhs) requires(std::is_copy_constructible_v<T>)
-      : ptr_(rhs.ptr_ == nullptr ? nullptr : new T(*rhs.ptr_)) {}
-  deep_ptr(deep_ptr&& rhs) noexcept : ptr_(rhs.ptr_) { rhs.ptr_ = nullptr; }
-  ~deep_ptr() noexcept { delete ptr_; }
+  proxy_view() noexcept : meta_(nullptr) {}
+  proxy_view(std::nullptr_t) noexcept : proxy_view() {}
+  proxy_view(const proxy<F>& p)
+      requires(details::basic_facade_traits<F>::options.proxy_views)
+      : proxy_view(details::proxy_helper<F>::get_view(p)) {}
+  template <class T>
+  proxy_view(T& value) noexcept
+      requires(!std::is_same_v<std::remove_cv_t<T>, proxy<F>> &&
+          !std::is_same_v<std::remove_cv_t<T>, proxy_view> &&
+          Traits::template applicable_dispatch_ptr<T*>)
+      : meta_(&details::view_meta_storage<F, T>) {
+    static_assert(sizeof(T*) == sizeof(void*));
+    new(ptr_) T*(std::addressof(value));
+  }
+  proxy_view(const proxy_view&) noexcept = default;
+  proxy_view& operator=(const proxy_view&) noexcept = default;
 
-  T* operator->() const noexcept { return ptr_; }
+  bool has_value() const noexcept { return meta_ != nullptr; }
+  template <class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke(Args&&... args) const
+      noexcept(details::overload_traits<MatchedOverload<D, Args...>>
+          ::is_noexcept)
+      requires(details::basic_facade_traits<F>::template has_dispatch<D> &&
+          requires { typename MatchedOverload<D, Args...>; }) {
+    return details::invoke_dispatch<D, MatchedOverload<D, Args...>>(
+        *meta_, ptr_, std::forward<Args>(args)...);
+  }
+  template <class... Args>
+  decltype(auto) operator()(Args&&... args) const
+      noexcept(details::overload_traits<
+          MatchedOverload<DefaultDispatch, Args...>>::is_noexcept)
+      requires(requires {
+          typename MatchedOverload<DefaultDispatch, Args...>; })
+      { return invoke(std::forward<Args>(args)...); }
 
  private:
-  T* ptr_;
+  const typename Traits::dispatch_meta* meta_;
+  alignas(void*) char ptr_[sizeof(void*)];
 };
 
-template <class F, class T, class... Args>
-proxy<F> make_proxy_impl(Args&&... args) {
-  return proxy<F>{std::in_place_type<
-      std::conditional_t<proxiable<sbo_ptr<T>, F>, sbo_ptr<T>, deep_ptr<T>>>,
-      std::forward<Args>(args)...};
+namespace details {
+
+template <class T, class... Ts>
+consteval std::size_t sealed_index_of() {
+  std::size_t result = 0u;
+  ((std::is_same_v<T, Ts> ? false : (++result, true)) && ...);
+  return result;
 }
 
-}  // namespace details
+template <class... Ts>
+consteval std::size_t sealed_storage_size() {
+  std::size_t result = 0u;
+  ((result = sizeof(Ts) > result ? sizeof(Ts) : result), ...);
+  return result;
+}
+
+// Alternatives of a sealed_proxy are stored in place, so they are subject to
+// the constraints of the facade that apply to pointers
+template <class F, class T>
+constexpr bool sealed_applicable = sizeof(T) <= F::constraints.max_size &&
+    alignof(T) <= F::constraints.max_align &&
+    has_copyability<T>(F::constraints.copyability) &&
+    has_relocatability<T>(F::constraints.relocatability,
+        get_facade_options<F>().relocatable_by_trait) &&
+    has_destructibility<T>(F::constraints.destructibility) &&
+    facade_traits<F>::template applicable_dispatch_ptr<T*>;
+
+// Compilers lower the chain of comparisons to a jump table when profitable.
+// An index that matches none of the alternatives (i.e., the sealed_proxy is
+// empty) throws bad_proxy_invocation
+template <std::size_t I, class... Ts, class Fn>
+decltype(auto) sealed_visit(std::size_t index, char* storage, Fn&& fn) {
+  using T = std::tuple_element_t<I, std::tuple<Ts...>>;
+  if constexpr (I + 1u == sizeof...(Ts)) {
+    if (index != I) {
+      throw bad_proxy_invocation{};
+    }
+    return fn(*reinterpret_cast<T*>(storage));
+  } else {
+    if (index == I) {
+      return fn(*reinterpret_cast<T*>(storage));
+    }
+    return sealed_visit<I + 1u, Ts...>(index, storage, std::forward<Fn>(fn));
+  }
+}
+
+}  // namespace details
+
+// Stores an object of one of the types Ts in place, along with its index in
+// Ts instead of a pointer to a meta table. Invocations call the dispatchers
+// of the stored type directly, so that they can be inlined. Invoking an empty
+// sealed_proxy throws bad_proxy_invocation
+template <facade F, class... Ts>
+    requires(sizeof...(Ts) > 0u && (details::sealed_applicable<F, Ts> && ...))
+class sealed_proxy {
+  using DefaultDispatch = typename details::basic_facade_traits<F>
+      ::default_dispatch;
+  template <class D, class... Args>
+  using MatchedOverload =
+      typename details::dispatch_traits<D>::template matched_overload<Args...>;
+  using Index = std::conditional_t<
+      sizeof...(Ts) < 255u, std::uint8_t, std::size_t>;
+
+  static constexpr Index npos = static_cast<Index>(sizeof...(Ts));
+  template <class T>
+  static constexpr Index IndexOf =
+      static_cast<Index>(details::sealed_index_of<T, Ts...>());
+  template <class T>
+  static constexpr bool Contains = IndexOf<T> != npos;
+  static constexpr bool HasNothrowCopyConstructor =
+      (std::is_nothrow_copy_constructible_v<Ts> && ...);
+  static constexpr bool HasCopyConstructor =
+      (std::is_copy_constructible_v<Ts> && ...);
+  static constexpr bool HasNothrowMoveConstructor =
+      (std::is_nothrow_move_constructible_v<Ts> && ...);
+  static constexpr bool HasMoveConstructor =
+      (std::is_move_constructible_v<Ts> && ...);
+  static constexpr bool HasTrivialDestructor =
+      (std::is_trivially_destructible_v<Ts> && ...);
+
+ public:
+  sealed_proxy() noexcept : index_(npos) {}
+  sealed_proxy(std::nullptr_t) noexcept : sealed_proxy() {}
+  sealed_proxy(const sealed_proxy& rhs) noexcept(HasNothrowCopyConstructor)
+      requires(HasCopyConstructor) : index_(npos) {
+    if (rhs.has_value()) {
+      rhs.visit([this]<class T>(T& object) { new(storage_) T(object); });
+      index_ = rhs.index_;
+    }
+  }
+  sealed_proxy(sealed_proxy&& rhs) noexcept(HasNothrowMoveConstructor)
+      requires(HasMoveConstructor) : index_(npos) {
+    if (rhs.has_value()) {
+      rhs.visit([this]<class T>(T& object)
+          { new(storage_) T(std::move(object)); });
+      index_ = rhs.index_;
+      rhs.reset();
+    }
+  }
+  template <class T>
+  sealed_proxy(T&& value)
+      noexcept(std::is_nothrow_constructible_v<std::decay_t<T>, T>)
+      requires(Contains<std::decay_t<T>>)
+      { initialize<std::decay_t<T>>(std::forward<T>(value)); }
+  template <class T, class... Args>
+  explicit sealed_proxy(std::in_place_type_t<T>, Args&&... args)
+      noexcept(std::is_nothrow_constructible_v<T, Args...>)
+      requires(Contains<T> && std::is_constructible_v<T, Args...>)
+      { initialize<T>(std::forward<Args>(args)...); }
+  sealed_proxy& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+  sealed_proxy& operator=(const sealed_proxy& rhs)
+      requires(HasCopyConstructor && HasMoveConstructor) {
+    if (this != &rhs) {
+      sealed_proxy temp{rhs};
+      *this = std::move(temp);
+    }
+    return *this;
+  }
+  sealed_proxy& operator=(sealed_proxy&& rhs)
+      noexcept(HasNothrowMoveConstructor) requires(HasMoveConstructor) {
+    if (this != &rhs) {
+      reset();
+      new(this) sealed_proxy(std::move(rhs));
+    }
+    return *this;
+  }
+  ~sealed_proxy() requires(HasTrivialDestructor) = default;
+  ~sealed_proxy() noexcept requires(!HasTrivialDestructor) { reset(); }
+
+  bool has_value() const noexcept { return index_ != npos; }
+  void reset() noexcept {
+    if (has_value()) {
+      visit([]<class T>(T& object) { object.~T(); });
+      index_ = npos;
+    }
+  }
+  template <class T>
+  bool has_type() const noexcept requires(Contains<T>)
+      { return index_ == IndexOf<T>; }
+  template <class T>
+  T* target() noexcept requires(Contains<T>)
+      { return has_type<T>() ? reinterpret_cast<T*>(storage_) : nullptr; }
+  template <class T>
+  const T* target() const noexcept requires(Contains<T>) {
+    return has_type<T>() ? reinterpret_cast<const T*>(storage_) : nullptr;
+  }
+  template <class T, class... Args>
+  T& emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible_v<T, Args...>)
+      requires(Contains<T> && std::is_constructible_v<T, Args...>) {
+    reset();
+    initialize<T>(std::forward<Args>(args)...);
+    return *reinterpret_cast<T*>(storage_);
+  }
+  template <class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke(Args&&... args) const
+      noexcept(details::overload_traits<MatchedOverload<D, Args...>>
+          ::is_noexcept)
+      requires(details::basic_facade_traits<F>::template has_dispatch<D> &&
+          requires { typename MatchedOverload<D, Args...>; }) {
+    using O = MatchedOverload<D, Args...>;
+    return visit([&]<class T>(T& object) -> decltype(auto) {
+      T* ptr = &object;
+      return details::overload_traits<O>::call(
+          &details::overload_traits<O>::template dispatcher<D, T*>,
+          reinterpret_cast<const char*>(&ptr), std::forward<Args>(args)...);
+    });
+  }
+  template <class... Args>
+  decltype(auto) operator()(Args&&... args) const
+      noexcept(details::overload_traits<
+          MatchedOverload<DefaultDispatch, Args...>>::is_noexcept)
+      requires(requires {
+          typename MatchedOverload<DefaultDispatch, Args...>; })
+      { return invoke(std::forward<Args>(args)...); }
+
+ private:
+  template <class T, class... Args>
+  void initialize(Args&&... args) {
+    new(storage_) T(std::forward<Args>(args)...);
+    index_ = IndexOf<T>;
+  }
+  template <class Fn>
+  decltype(auto) visit(Fn&& fn) const
+      { return details::sealed_visit<0u, Ts...>(index_, storage_, fn); }
+
+  Index index_;
+  alignas(Ts...) mutable char storage_[details::sealed_storage_size<Ts...>()];
+};
+
+namespace details {
+
+template <class F>
+template <class P>
+proxy_view<F> view_meta_accessor<F>::get_view(const char* erased) {
+  const P& ptr = *reinterpret_cast<const P*>(erased);
+  if constexpr (requires { typename ptr_traits<P>::mutable_reference_type; }) {
+    return proxy_view<F>{*ptr_traits<P>::to_mutable_address(ptr)};
+  } else {
+    return proxy_view<F>{*ptr_traits<P>::to_address(ptr)};
+  }
+}
+
+}  // namespace details
+
+// Counters of the pooled allocation on the calling thread
+struct pool_statistics {
+  std::size_t allocations = 0u;
+  std::size_t deallocations = 0u;
+  std::size_t remote_deallocations = 0u;  // Freed into a pool of another thread
+  std::size_t chunk_allocations = 0u;
+};
+
+// Whether the reference count of a shared object is updated atomically
+enum class refcount_policy { atomic, nonatomic };
+
+namespace details {
+
+template <class T>
+class sbo_ptr {
+ public:
+  template <class... Args>
+  sbo_ptr(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+      requires(std::is_constructible_v<T, Args...>)
+      : value_(std::forward<Args>(args)...) {}
+  sbo_ptr(const sbo_ptr&) noexcept(std::is_nothrow_copy_constructible_v<T>)
+      = default;
+  sbo_ptr(sbo_ptr&&) noexcept(std::is_nothrow_move_constructible_v<T>)
+      = default;
+
+  T* operator->() const noexcept { return &value_; }
+
+ private:
+  [[___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE]] mutable T value_;
+};
+
+template <class T>
+struct field_address_traits<sbo_ptr<T>> {
+  using element_type = T;
+  static constexpr field_access access = field_access::direct;
+};
+
+template <class T>
+class deep_ptr {
+ public:
+  template <class... Args>
+  deep_ptr(Args&&... args) requires(std::is_constructible_v<T, Args...>)
+      : ptr_(new T(std::forward<Args>(args)...)) {}
+  deep_ptr(const deep_ptr& rhs) requires(std::is_copy_constructible_v<T>)
+      : ptr_(rhs.ptr_ == nullptr ? nullptr : new T(*rhs.ptr_)) {}
+  deep_ptr(deep_ptr&& rhs) noexcept : ptr_(rhs.ptr_) { rhs.ptr_ = nullptr; }
+  ~deep_ptr() noexcept { delete ptr_; }
+
+  T* operator->() const noexcept { return ptr_; }
+
+ private:
+  T* ptr_;
+};
+
+template <class T>
+struct field_address_traits<deep_ptr<T>> {
+  using element_type = T;
+  static constexpr field_access access = field_access::indirect;
+};
+
+template <class T, class Alloc>
+class allocated_ptr {
+  using AllocTraits = std::allocator_traits<Alloc>;
+
+ public:
+  template <class... Args>
+  allocated_ptr(const Alloc& alloc, Args&&... args)
+      requires(std::is_constructible_v<T, Args...>)
+      : alloc_(alloc), ptr_(AllocTraits::allocate(alloc_, 1u)) {
+    try {
+      AllocTraits::construct(alloc_, std::to_address(ptr_),
+          std::forward<Args>(args)...);
+    } catch (...) {
+      AllocTraits::deallocate(alloc_, ptr_, 1u);
+      throw;
+    }
+  }
+  allocated_ptr(const allocated_ptr& rhs)
+      requires(std::is_copy_constructible_v<T>)
+      : allocated_ptr(rhs.alloc_, *rhs.operator->()) {}
+  allocated_ptr(allocated_ptr&& rhs) noexcept
+      : alloc_(std::move(rhs.alloc_)), ptr_(std::move(rhs.ptr_))
+      { rhs.ptr_ = nullptr; }
+  ~allocated_ptr() noexcept {
+    if (ptr_ != nullptr) {
+      AllocTraits::destroy(alloc_, std::to_address(ptr_));
+      AllocTraits::deallocate(alloc_, ptr_, 1u);
+    }
+  }
+
+  T* operator->() const noexcept { return std::to_address(ptr_); }
+
+ private:
+  [[___PRO_NO_UNIQUE_ADDRESS_ATTRIBUTE]] Alloc alloc_;
+  typename AllocTraits::pointer ptr_;
+};
+
+template <refcount_policy P> class ref_counter;
+template <>
+class ref_counter<refcount_policy::atomic> {
+ public:
+  void add_ref() noexcept { count_.fetch_add(1u, std::memory_order_relaxed); }
+  bool release() noexcept
+      { return count_.fetch_sub(1u, std::memory_order_acq_rel) == 1u; }
+  bool unique() const noexcept
+      { return count_.load(std::memory_order_acquire) == 1u; }
+  bool try_add_ref() noexcept {
+    std::size_t count = count_.load(std::memory_order_relaxed);
+    do {
+      if (count == 0u) {
+        return false;
+      }
+    } while (!count_.compare_exchange_weak(count, count + 1u,
+        std::memory_order_acquire, std::memory_order_relaxed));
+    return true;
+  }
+  bool expired() const noexcept
+      { return count_.load(std::memory_order_acquire) == 0u; }
+
+ private:
+  std::atomic<std::size_t> count_{1u};
+};
+template <>
+class ref_counter<refcount_policy::nonatomic> {
+ public:
+  void add_ref() noexcept { ++count_; }
+  bool release() noexcept { return --count_ == 0u; }
+  bool unique() const noexcept { return count_ == 1u; }
+  bool try_add_ref() noexcept {
+    if (count_ == 0u) {
+      return false;
+    }
+    ++count_;
+    return true;
+  }
+  bool expired() const noexcept { return count_ == 0u; }
+
+ private:
+  std::size_t count_ = 1u;
+};
+
+// Keeps the reference count next to the object in a single allocation, so
+// that the pointer itself is only one word
+template <class T, refcount_policy P>
+struct shared_storage {
+  template <class... Args>
+  explicit shared_storage(Args&&... args)
+      : value(std::forward<Args>(args)...) {}
+
+  T value;
+  ref_counter<P> ref_count;
+};
+
+// Same as shared_storage, except that the object is destroyed with the last
+// strong reference, while the storage lives on until the last weak reference
+// is released. Strong references collectively hold one weak reference
+template <class T, refcount_policy P>
+struct weak_shared_storage {
+  template <class... Args>
+  explicit weak_shared_storage(Args&&... args)
+      : value(std::forward<Args>(args)...) {}
+  ~weak_shared_storage() {}
+
+  union { T value; };
+  ref_counter<P> ref_count;
+  ref_counter<P> weak_count;
+};
+
+// The weak count is only allocated when W is true, i.e., when the facade
+// supports weak_proxy
+template <class T, refcount_policy P, bool W>
+class shared_compact_ptr {
+  using storage = std::conditional_t<W, weak_shared_storage<T, P>,
+      shared_storage<T, P>>;
+
+ public:
+  struct adopt_t { void* ptr; };
+
+  template <class... Args>
+  explicit shared_compact_ptr(std::in_place_t, Args&&... args)
+      requires(std::is_constructible_v<T, Args...>)
+      : ptr_(new storage(std::forward<Args>(args)...)) {}
+  explicit shared_compact_ptr(adopt_t a) noexcept requires(W)
+      : ptr_(static_cast<storage*>(a.ptr)) {}
+  shared_compact_ptr(const shared_compact_ptr& rhs) noexcept : ptr_(rhs.ptr_)
+      { ptr_->ref_count.add_ref(); }
+  shared_compact_ptr(shared_compact_ptr&& rhs) noexcept : ptr_(rhs.ptr_)
+      { rhs.ptr_ = nullptr; }
+  ~shared_compact_ptr() noexcept {
+    if (ptr_ != nullptr && ptr_->ref_count.release()) {
+      if constexpr (W) {
+        std::destroy_at(&ptr_->value);
+        release_weak(ptr_);
+      } else {
+        delete ptr_;
+      }
+    }
+  }
+
+  T* operator->() const noexcept { return &ptr_->value; }
+
+  void* acquire_weak() const noexcept requires(W) {
+    ptr_->weak_count.add_ref();
+    return ptr_;
+  }
+  static void add_weak(void* s) noexcept requires(W)
+      { static_cast<storage*>(s)->weak_count.add_ref(); }
+  static void release_weak(void* s) noexcept requires(W) {
+    if (static_cast<storage*>(s)->weak_count.release()) {
+      delete static_cast<storage*>(s);
+    }
+  }
+  static bool expired(const void* s) noexcept requires(W)
+      { return static_cast<const storage*>(s)->ref_count.expired(); }
+  static bool try_lock(void* s) noexcept requires(W)
+      { return static_cast<storage*>(s)->ref_count.try_add_ref(); }
+
+ private:
+  storage* ptr_;
+};
+
+// Copies share the object until one of them is dispatched with a non-const
+// operation, which clones the object first if it is still shared
+template <class T>
+class cow_ptr {
+  using storage = shared_storage<T, refcount_policy::atomic>;
+
+ public:
+  template <class... Args>
+  explicit cow_ptr(std::in_place_t, Args&&... args)
+      requires(std::is_constructible_v<T, Args...>)
+      : ptr_(new storage(std::forward<Args>(args)...)) {}
+  cow_ptr(const cow_ptr& rhs) noexcept : ptr_(rhs.ptr_)
+      { ptr_->ref_count.add_ref(); }
+  cow_ptr(cow_ptr&& rhs) noexcept : ptr_(rhs.ptr_) { rhs.ptr_ = nullptr; }
+  ~cow_ptr() noexcept {
+    if (ptr_ != nullptr && ptr_->ref_count.release()) {
+      delete ptr_;
+    }
+  }
+
+  const T* operator->() const noexcept { return &ptr_->value; }
+  T* unshare() const {
+    if (!ptr_->ref_count.unique()) {
+      storage* copy = new storage(std::as_const(ptr_->value));
+      if (ptr_->ref_count.release()) {
+        delete ptr_;
+      }
+      ptr_ = copy;
+    }
+    return &ptr_->value;
+  }
+
+ private:
+  mutable storage* ptr_;
+};
+
+constexpr std::size_t pool_min_block_size = 16u;
+constexpr std::size_t pool_max_block_size = 256u;
+constexpr std::size_t pool_chunk_size = 64u * 1024u;
+
+constexpr std::size_t pool_size_class_of(std::size_t size) noexcept {
+  return size <= pool_min_block_size ? 0u :
+      static_cast<std::size_t>(std::bit_width(size - 1u)) -
+          static_cast<std::size_t>(std::bit_width(pool_min_block_size - 1u));
+}
+
+// Each thread serves small blocks from size-class freelists carved out of
+// aligned chunks. The chunk header records the owning pool, so a block freed
+// by another thread is pushed onto a lock-free list of its owner. Pools of
+// exited threads are parked and adopted by new threads.
+class block_pool {
+ public:
+  static block_pool& current() {
+    thread_local pool_guard guard;
+    return *guard.pool;
+  }
+
+  void* allocate(std::size_t size) {
+    std::size_t sc = pool_size_class_of(size);
+    ++statistics().allocations;
+    free_block* result = free_lists_[sc];
+    if (result == nullptr) {
+      result = remote_free_lists_[sc].exchange(nullptr,
+          std::memory_order_acquire);
+      if (result == nullptr) {
+        return carve(sc);
+      }
+    }
+    free_lists_[sc] = result->next;
+    return result;
+  }
+  static void deallocate(void* p, std::size_t size) noexcept {
+    std::size_t sc = pool_size_class_of(size);
+    block_pool* owner = reinterpret_cast<chunk_header*>(
+        reinterpret_cast<std::uintptr_t>(p) & ~(pool_chunk_size - 1u))->owner;
+    free_block* block = new(p) free_block;
+    ++statistics().deallocations;
+    if (owner == current_ptr()) {
+      block->next = owner->free_lists_[sc];
+      owner->free_lists_[sc] = block;
+    } else {
+      free_block* head = owner->remote_free_lists_[sc].load(
+          std::memory_order_relaxed);
+      do {
+        block->next = head;
+      } while (!owner->remote_free_lists_[sc].compare_exchange_weak(
+          head, block, std::memory_order_release, std::memory_order_relaxed));
+      ++statistics().remote_deallocations;
+    }
+  }
+  static pool_statistics& statistics() noexcept {
+    thread_local pool_statistics result;
+    return result;
+  }
+
+ private:
+  static constexpr std::size_t size_class_count =
+      pool_size_class_of(pool_max_block_size) + 1u;
+
+  struct free_block { free_block* next; };
+  struct chunk_header { block_pool* owner; };
+  struct pool_guard {
+    pool_guard() : pool(adopt()) { current_ptr() = pool; }
+    ~pool_guard() {
+      current_ptr() = nullptr;
+      std::lock_guard lock{registry_mutex()};
+      pool->next_parked_ = parked_head();
+      parked_head() = pool;
+    }
+
+    block_pool* pool;
+  };
+
+  static block_pool* adopt() {
+    {
+      std::lock_guard lock{registry_mutex()};
+      block_pool* result = parked_head();
+      if (result != nullptr) {
+        parked_head() = result->next_parked_;
+        return result;
+      }
+    }
+    return new block_pool();
+  }
+  static block_pool*& current_ptr() noexcept {
+    thread_local block_pool* result = nullptr;
+    return result;
+  }
+  static std::mutex& registry_mutex() noexcept {
+    static std::mutex result;
+    return result;
+  }
+  static block_pool*& parked_head() noexcept {
+    static block_pool* result = nullptr;
+    return result;
+  }
+
+  void* carve(std::size_t sc) {
+    std::size_t block_size = pool_min_block_size << sc;
+    if (bump_[sc] == bump_end_[sc]) {
+      char* chunk = static_cast<char*>(::operator new(pool_chunk_size,
+          std::align_val_t{pool_chunk_size}));
+      new(chunk) chunk_header{this};
+      ++statistics().chunk_allocations;
+      std::size_t offset = (sizeof(chunk_header) + block_size - 1u) /
+          block_size * block_size;
+      bump_[sc] = chunk + offset;
+      bump_end_[sc] = chunk + offset +
+          (pool_chunk_size - offset) / block_size * block_size;
+    }
+    void* result = bump_[sc];
+    bump_[sc] += block_size;
+    return result;
+  }
+
+  free_block* free_lists_[size_class_count] = {};
+  std::atomic<free_block*> remote_free_lists_[size_class_count] = {};
+  char* bump_[size_class_count] = {};
+  char* bump_end_[size_class_count] = {};
+  block_pool* next_parked_ = nullptr;
+};
+
+inline void* pool_allocate(std::size_t size, std::size_t alignment) {
+  if (size <= pool_max_block_size) {
+    return block_pool::current().allocate(size);
+  }
+  if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return ::operator new(size, std::align_val_t{alignment});
+  }
+  return ::operator new(size);
+}
+inline void pool_deallocate(void* p, std::size_t size, std::size_t alignment)
+    noexcept {
+  if (size <= pool_max_block_size) {
+    block_pool::deallocate(p, size);
+  } else if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    ::operator delete(p, size, std::align_val_t{alignment});
+  } else {
+    ::operator delete(p, size);
+  }
+}
+
+}  // namespace details
+
+// Serves blocks of up to 256 bytes from thread-local size-class pools; larger
+// blocks fall back to operator new. A block may be freed on any thread
+template <class T>
+class pooled_allocator {
+ public:
+  using value_type = T;
+
+  pooled_allocator() noexcept = default;
+  template <class U>
+  pooled_allocator(const pooled_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        details::pool_allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, std::size_t n) noexcept
+      { details::pool_deallocate(p, n * sizeof(T), alignof(T)); }
+
+  template <class U>
+  bool operator==(const pooled_allocator<U>&) const noexcept { return true; }
+};
+
+inline pool_statistics get_pool_statistics() noexcept
+    { return details::block_pool::statistics(); }
+
+template <class T>
+struct is_trivially_relocatable<details::sbo_ptr<T>>
+    : is_trivially_relocatable<T> {};
+template <class T>
+struct is_trivially_relocatable<details::deep_ptr<T>> : std::true_type {};
+template <class T, class Alloc>
+struct is_trivially_relocatable<details::allocated_ptr<T, Alloc>>
+    : std::bool_constant<is_trivially_relocatable_v<Alloc> &&
+          is_trivially_relocatable_v<
+              typename std::allocator_traits<Alloc>::pointer>> {};
+template <class T, refcount_policy P, bool W>
+struct is_trivially_relocatable<details::shared_compact_ptr<T, P, W>>
+    : std::true_type {};
+template <class T>
+struct is_trivially_relocatable<details::cow_ptr<T>> : std::true_type {};
+template <class T, class D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>>
+    : std::bool_constant<is_trivially_relocatable_v<D> &&
+          is_trivially_relocatable_v<typename std::unique_ptr<T, D>::pointer>>
+    {};
+template <class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+namespace details {
+
+template <class F, class T, class Alloc, class... Args>
+proxy<F> allocate_proxy_impl(const Alloc& alloc, Args&&... args) {
+  using TypedAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+  return proxy<F>{std::in_place_type<allocated_ptr<T, TypedAlloc>>,
+      TypedAlloc(alloc), std::forward<Args>(args)...};
+}
+
+template <class F, class T>
+using make_proxy_ptr =
+    std::conditional_t<proxiable<sbo_ptr<T>, F>, sbo_ptr<T>, deep_ptr<T>>;
+
+template <class F, class T, class... Args>
+proxy<F> make_proxy_impl(Args&&... args) {
+  return proxy<F>{std::in_place_type<make_proxy_ptr<F, T>>,
+      std::forward<Args>(args)...};
+}
+
+template <class F, class T, class... Args>
+proxy<F> make_proxy_cow_impl(Args&&... args) {
+  if constexpr (proxiable<sbo_ptr<T>, F>) {
+    return proxy<F>{std::in_place_type<sbo_ptr<T>>,
+        std::forward<Args>(args)...};
+  } else {
+    return proxy<F>{std::in_place_type<cow_ptr<T>>, std::in_place,
+        std::forward<Args>(args)...};
+  }
+}
+
+template <class F, class T, class... Args>
+proxy<F> make_proxy_pooled_impl(Args&&... args) {
+  if constexpr (proxiable<sbo_ptr<T>, F>) {
+    return proxy<F>{std::in_place_type<sbo_ptr<T>>,
+        std::forward<Args>(args)...};
+  } else {
+    return allocate_proxy_impl<F, T>(pooled_allocator<T>{},
+        std::forward<Args>(args)...);
+  }
+}
+
+}  // namespace details
 
 template <class F, class T, class... Args>
 proxy<F> make_proxy(Args&&... args)
@@ -609,26 +2035,831 @@ proxy<F> make_proxy(T&& value) {
   return details::make_proxy_impl<F, std::decay_t<T>>(std::forward<T>(value));
 }
 
+// Unlike make_proxy(), the object is always allocated with the given
+// allocator, which is also used to copy and destroy it
+template <class F, class T, class Alloc, class... Args>
+proxy<F> allocate_proxy(const Alloc& alloc, Args&&... args)
+    requires(requires { typename Alloc::value_type; }) {
+  return details::allocate_proxy_impl<F, T>(
+      alloc, std::forward<Args>(args)...);
+}
+template <class F, class T, class Alloc, class U, class... Args>
+proxy<F> allocate_proxy(const Alloc& alloc, std::initializer_list<U> il,
+    Args&&... args) requires(requires { typename Alloc::value_type; }) {
+  return details::allocate_proxy_impl<F, T>(
+      alloc, il, std::forward<Args>(args)...);
+}
+template <class F, class T, class... Args>
+proxy<F> allocate_proxy(std::pmr::memory_resource* memory_resource,
+    Args&&... args) {
+  return details::allocate_proxy_impl<F, T>(
+      std::pmr::polymorphic_allocator<>{memory_resource},
+      std::forward<Args>(args)...);
+}
+template <class F, class T, class U, class... Args>
+proxy<F> allocate_proxy(std::pmr::memory_resource* memory_resource,
+    std::initializer_list<U> il, Args&&... args) {
+  return details::allocate_proxy_impl<F, T>(
+      std::pmr::polymorphic_allocator<>{memory_resource}, il,
+      std::forward<Args>(args)...);
+}
+
+// Same as make_proxy(), except that objects not fitting in the proxy are
+// allocated with pooled_allocator instead of operator new
+template <class F, class T, class... Args>
+proxy<F> make_proxy_pooled(Args&&... args) {
+  return details::make_proxy_pooled_impl<F, T>(std::forward<Args>(args)...);
+}
+template <class F, class T, class U, class... Args>
+proxy<F> make_proxy_pooled(std::initializer_list<U> il, Args&&... args) {
+  return details::make_proxy_pooled_impl<F, T>(
+      il, std::forward<Args>(args)...);
+}
+template <class F, class T>
+proxy<F> make_proxy_pooled(T&& value) {
+  return details::make_proxy_pooled_impl<F, std::decay_t<T>>(
+      std::forward<T>(value));
+}
+
+// Same as make_proxy(), except that objects not fitting in the proxy are
+// shared between copies until a non-const dispatch, which clones the object
+template <class F, class T, class... Args>
+proxy<F> make_proxy_cow(Args&&... args)
+    { return details::make_proxy_cow_impl<F, T>(std::forward<Args>(args)...); }
+template <class F, class T, class U, class... Args>
+proxy<F> make_proxy_cow(std::initializer_list<U> il, Args&&... args) {
+  return details::make_proxy_cow_impl<F, T>(
+      il, std::forward<Args>(args)...);
+}
+template <class F, class T>
+proxy<F> make_proxy_cow(T&& value) {
+  return details::make_proxy_cow_impl<F, std::decay_t<T>>(
+      std::forward<T>(value));
+}
+
+// Copies of the returned proxy share the same object, which is destroyed
+// with the last copy
+template <class F, class T, refcount_policy P = refcount_policy::atomic,
+    class... Args>
+proxy<F> make_proxy_shared(Args&&... args) {
+  return proxy<F>{std::in_place_type<details::shared_compact_ptr<T, P,
+          details::get_facade_options<F>().weak_references>>,
+      std::in_place, std::forward<Args>(args)...};
+}
+template <class F, class T, refcount_policy P = refcount_policy::atomic,
+    class U, class... Args>
+proxy<F> make_proxy_shared(std::initializer_list<U> il, Args&&... args) {
+  return proxy<F>{std::in_place_type<details::shared_compact_ptr<T, P,
+          details::get_facade_options<F>().weak_references>>,
+      std::in_place, il, std::forward<Args>(args)...};
+}
+template <class F, refcount_policy P = refcount_policy::atomic, class T>
+proxy<F> make_proxy_shared(T&& value) {
+  return proxy<F>{std::in_place_type<details::shared_compact_ptr<
+          std::decay_t<T>, P,
+          details::get_facade_options<F>().weak_references>>,
+      std::in_place, std::forward<T>(value)};
+}
+
+namespace details {
+
+template <class F>
+struct weak_ops {
+  template <class P>
+  constexpr explicit weak_ops(std::in_place_type_t<P>)
+      : acquire(&acquire_impl<P>), add_ref(&P::add_weak),
+        release(&P::release_weak), expired(&P::expired), lock(&lock_impl<P>) {}
+
+  template <class P>
+  static void* acquire_impl(const char* erased) noexcept
+      { return reinterpret_cast<const P*>(erased)->acquire_weak(); }
+  template <class P>
+  static proxy<F> lock_impl(void* storage) noexcept {
+    if (!P::try_lock(storage)) {
+      return nullptr;
+    }
+    return proxy<F>{std::in_place_type<P>, typename P::adopt_t{storage}};
+  }
+
+  void* (*acquire)(const char*) noexcept;
+  void (*add_ref)(void*) noexcept;
+  void (*release)(void*) noexcept;
+  bool (*expired)(const void*) noexcept;
+  proxy<F> (*lock)(void*) noexcept;
+};
+template <class F, class P>
+inline constexpr weak_ops<F> weak_ops_storage{std::in_place_type<P>};
+template <class F, class T, refcount_policy P>
+inline constexpr const weak_ops<F>*
+    weak_ops_of<F, shared_compact_ptr<T, P, true>> =
+        &weak_ops_storage<F, shared_compact_ptr<T, P, true>>;
+
+}  // namespace details
+
+// Refers to the object of a proxy created by make_proxy_shared() without
+// keeping it alive. lock() yields a proxy sharing the object if it still
+// exists, with the same meta table as the proxies it was observed from.
+// Proxies of other pointer types are observed as expired
+template <facade F>
+    requires(details::basic_facade_traits<F>::options.weak_references)
+class weak_proxy {
+ public:
+  weak_proxy() noexcept : ops_(nullptr), storage_(nullptr) {}
+  weak_proxy(std::nullptr_t) noexcept : weak_proxy() {}
+  weak_proxy(const proxy<F>& p) noexcept : weak_proxy() {
+    ops_ = details::proxy_helper<F>::get_weak_ops(p);
+    if (ops_ != nullptr) {
+      storage_ = ops_->acquire(details::proxy_helper<F>::get_storage(p));
+    }
+  }
+  weak_proxy(const weak_proxy& rhs) noexcept
+      : ops_(rhs.ops_), storage_(rhs.storage_) {
+    if (ops_ != nullptr) {
+      ops_->add_ref(storage_);
+    }
+  }
+  weak_proxy(weak_proxy&& rhs) noexcept
+      : ops_(rhs.ops_), storage_(rhs.storage_) { rhs.ops_ = nullptr; }
+  ~weak_proxy() noexcept { reset(); }
+  weak_proxy& operator=(const weak_proxy& rhs) noexcept {
+    weak_proxy{rhs}.swap(*this);
+    return *this;
+  }
+  weak_proxy& operator=(weak_proxy&& rhs) noexcept {
+    weak_proxy{std::move(rhs)}.swap(*this);
+    return *this;
+  }
+
+  bool expired() const noexcept
+      { return ops_ == nullptr || ops_->expired(storage_); }
+  proxy<F> lock() const noexcept
+      { return ops_ == nullptr ? proxy<F>{} : ops_->lock(storage_); }
+  void reset() noexcept {
+    if (ops_ != nullptr) {
+      ops_->release(storage_);
+      ops_ = nullptr;
+    }
+  }
+  void swap(weak_proxy& rhs) noexcept {
+    std::swap(ops_, rhs.ops_);
+    std::swap(storage_, rhs.storage_);
+  }
+  friend void swap(weak_proxy& lhs, weak_proxy& rhs) noexcept { lhs.swap(rhs); }
+
+ private:
+  const details::weak_ops<F>* ops_;
+  void* storage_;
+};
+
+namespace details {
+
+// Epoch-based reclamation shared by all atomic_proxy instances. A reader
+// announces the global epoch in its thread record for the duration of a
+// guard. A writer stamps a retired node with the global epoch and links it
+// into the retired list of its own thread record, so retiring neither locks
+// nor allocates. Every reclaim_threshold retirements, the writer advances the
+// global epoch and frees the nodes of its list stamped before every announced
+// epoch. Records are registered in a lock-free list and are never freed: a
+// record is released when its thread exits, together with the nodes it could
+// not free yet, and adopted by the next thread that needs one.
+class epoch_domain {
+ public:
+  // Base of the nodes that can be retired
+  struct node {
+    node* next_retired = nullptr;
+    std::uint64_t epoch = 0u;
+    void (*deleter)(node*) noexcept = nullptr;
+  };
+
+ private:
+  struct record {
+    std::atomic<std::uint64_t> epoch{0u};
+    std::atomic<bool> in_use{true};
+    record* next = nullptr;
+    std::size_t depth = 0u;
+    node* retired = nullptr;
+    std::size_t retired_since_reclaim = 0u;
+  };
+
+ public:
+  class guard {
+   public:
+    guard() : rec_(current()) {
+      if (rec_->depth++ == 0u) {
+        rec_->epoch.store(global_epoch().load(std::memory_order_seq_cst),
+            std::memory_order_seq_cst);
+      }
+    }
+    guard(const guard&) = delete;
+    ~guard() {
+      if (--rec_->depth == 0u) {
+        rec_->epoch.store(0u, std::memory_order_release);
+      }
+    }
+    guard& operator=(const guard&) = delete;
+
+   private:
+    record* rec_;
+  };
+
+  static constexpr std::size_t reclaim_threshold = 64u;
+
+  // Returns whether reclaim() is due, i.e., whether reclaim_threshold nodes
+  // were retired by this thread since it last ran. The node must have been
+  // unlinked from every place where new readers could find it
+  static bool retire(node* n, void (*deleter)(node*) noexcept) {
+    record* rec = current();
+    n->epoch = global_epoch().load(std::memory_order_seq_cst);
+    n->deleter = deleter;
+    n->next_retired = rec->retired;
+    rec->retired = n;
+    return ++rec->retired_since_reclaim >= reclaim_threshold;
+  }
+  // Frees the nodes retired by this thread that no reader can observe
+  static void reclaim() { reclaim(current()); }
+  // Adopts a record for this thread ahead of retire, which then cannot throw
+  static void enroll() { current(); }
+
+ private:
+  struct record_guard {
+    record_guard() : rec(adopt()) {}
+    ~record_guard() {
+      reclaim(rec);
+      rec->in_use.store(false, std::memory_order_release);
+    }
+
+    record* rec;
+  };
+
+  static record* current() {
+    thread_local record_guard guard;
+    return guard.rec;
+  }
+  static record* adopt() {
+    std::atomic<record*>& head = records_head();
+    for (record* r = head.load(std::memory_order_acquire); r != nullptr;
+        r = r->next) {
+      bool in_use = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(in_use, true,
+              std::memory_order_acquire, std::memory_order_relaxed)) {
+        return r;
+      }
+    }
+    record* result = new record();
+    result->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(result->next, result,
+        std::memory_order_release, std::memory_order_relaxed)) {}
+    return result;
+  }
+  static void reclaim(record* rec) noexcept {
+    rec->retired_since_reclaim = 0u;
+    if (rec->retired == nullptr) {
+      return;
+    }
+    global_epoch().fetch_add(1u, std::memory_order_seq_cst);
+    std::uint64_t min_epoch = UINT64_MAX;
+    for (record* r = records_head().load(std::memory_order_acquire);
+        r != nullptr; r = r->next) {
+      std::uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+      if (e != 0u && e < min_epoch) { min_epoch = e; }
+    }
+    node** link = &rec->retired;
+    while (*link != nullptr) {
+      node* n = *link;
+      if (n->epoch < min_epoch) {
+        *link = n->next_retired;
+        n->deleter(n);
+      } else {
+        link = &n->next_retired;
+      }
+    }
+  }
+  static std::atomic<std::uint64_t>& global_epoch() noexcept {
+    static std::atomic<std::uint64_t> result{1u};
+    return result;
+  }
+  static std::atomic<record*>& records_head() noexcept {
+    static std::atomic<record*> result{nullptr};
+    return result;
+  }
+};
+
+}  // namespace details
+
+// Holds a proxy that can be replaced while other threads invoke it. Readers
+// never block; a replaced proxy is destroyed after no reader can observe it,
+// once the replacing thread has replaced a batch of proxies, when the
+// atomic_proxy is destroyed on that thread, or when that thread exits. The
+// atomic_proxy itself must outlive all concurrent calls.
+template <facade F>
+class atomic_proxy {
+  using DefaultDispatch = typename details::basic_facade_traits<F>
+      ::default_dispatch;
+  struct node : details::epoch_domain::node {
+    explicit node(proxy<F>&& p) noexcept(
+        std::is_nothrow_move_constructible_v<proxy<F>>)
+        : value(std::move(p)) {}
+
+    proxy<F> value;
+  };
+
+ public:
+  atomic_proxy() noexcept : current_(nullptr) {}
+  explicit atomic_proxy(proxy<F> p) : current_(make_node(std::move(p))) {}
+  atomic_proxy(const atomic_proxy&) = delete;
+  ~atomic_proxy() {
+    delete current_.load(std::memory_order_relaxed);
+    details::epoch_domain::reclaim();
+  }
+  atomic_proxy& operator=(const atomic_proxy&) = delete;
+
+  bool has_value() const noexcept
+      { return current_.load(std::memory_order_acquire) != nullptr; }
+  void store(proxy<F> p) {
+    details::epoch_domain::enroll();
+    node* n = make_node(std::move(p));
+    retire(current_.exchange(n, std::memory_order_seq_cst));
+  }
+  void reset() {
+    details::epoch_domain::enroll();
+    retire(current_.exchange(nullptr, std::memory_order_seq_cst));
+  }
+  proxy<F> load() const requires(std::is_copy_constructible_v<proxy<F>>) {
+    details::epoch_domain::guard g;
+    const node* n = current_.load(std::memory_order_seq_cst);
+    return n == nullptr ? proxy<F>{} : n->value;
+  }
+  // Like proxy::invoke, the behavior is undefined if *this does not hold a
+  // value
+  template <class D = DefaultDispatch, class... Args>
+  decltype(auto) invoke(Args&&... args) const
+      requires(requires(const proxy<F>& p) { p.template invoke<D>(
+          std::forward<Args>(args)...); }) {
+    details::epoch_domain::guard g;
+    return current_.load(std::memory_order_seq_cst)->value
+        .template invoke<D>(std::forward<Args>(args)...);
+  }
+  template <class... Args>
+  decltype(auto) operator()(Args&&... args) const
+      requires(requires { this->invoke(std::forward<Args>(args)...); })
+      { return invoke(std::forward<Args>(args)...); }
+
+ private:
+  static node* make_node(proxy<F>&& p)
+      { return p.has_value() ? new node(std::move(p)) : nullptr; }
+  static void retire(node* old) {
+    if (old != nullptr &&
+        details::epoch_domain::retire(old, &destroy_node)) {
+      details::epoch_domain::reclaim();
+    }
+  }
+  static void destroy_node(details::epoch_domain::node* n) noexcept
+      { delete static_cast<node*>(n); }
+
+  std::atomic<node*> current_;
+};
+
+namespace details {
+
+template <class F>
+struct proxy_helper {
+  static const void* get_meta(const proxy<F>& p) noexcept { return p.meta_; }
+  static const char* get_ptr(const proxy<F>& p) noexcept
+      { return p.dispatch_ptr(); }
+  template <class D, class O>
+  static typename overload_traits<O>::dispatcher_type get_dispatcher(
+      const proxy<F>& p) noexcept { return p.template get_dispatcher<D, O>(); }
+  template <class D>
+  static const typename dispatch_traits<D>::meta& get_dispatch_meta(
+      const proxy<F>& p) noexcept { return p.template get_dispatch_meta<D>(); }
+  static proxy_view<F> get_view(const proxy<F>& p) {
+    if (p.meta_ == nullptr) {
+      return nullptr;
+    }
+    return p.cold_meta().view_accessor(p.ptr_);
+  }
+  static bool relocates_trivially(const proxy<F>& p) noexcept
+      { return p.relocates_trivially(); }
+  static const weak_ops<F>* get_weak_ops(const proxy<F>& p) noexcept
+      { return p.meta_ == nullptr ? nullptr : p.cold_meta().weak; }
+  static const char* get_storage(const proxy<F>& p) noexcept
+      { return p.ptr_; }
+};
+
+class meta_grouping {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  meta_grouping() : slots_(16u, npos) {}
+
+  std::size_t group_of(const void* meta) {
+    if (meta == last_meta_) {
+      ++group_sizes_[last_group_];
+      return last_group_;
+    }
+    if ((group_metas_.size() + 1u) * 2u > slots_.size()) {
+      rehash(slots_.size() * 2u);
+    }
+    std::size_t& slot = find_slot(meta);
+    if (slot == npos) {
+      slot = group_metas_.size();
+      group_metas_.push_back(meta);
+      group_sizes_.push_back(0u);
+    }
+    last_meta_ = meta;
+    last_group_ = slot;
+    ++group_sizes_[slot];
+    return slot;
+  }
+  std::size_t group_count() const noexcept { return group_sizes_.size(); }
+  std::size_t group_size(std::size_t group) const noexcept
+      { return group_sizes_[group]; }
+
+ private:
+  std::size_t& find_slot(const void* meta) noexcept {
+    std::uintptr_t h = reinterpret_cast<std::uintptr_t>(meta);
+    h ^= h >> 17u;
+    h *= static_cast<std::uintptr_t>(0x9e3779b97f4a7c15ull);
+    h ^= h >> 29u;
+    std::size_t mask = slots_.size() - 1u;
+    for (std::size_t i = static_cast<std::size_t>(h) & mask;;
+        i = (i + 1u) & mask) {
+      if (slots_[i] == npos || group_metas_[slots_[i]] == meta) {
+        return slots_[i];
+      }
+    }
+  }
+  void rehash(std::size_t size) {
+    slots_.assign(size, npos);
+    for (std::size_t i = 0u; i < group_metas_.size(); ++i) {
+      find_slot(group_metas_[i]) = i;
+    }
+  }
+
+  std::vector<std::size_t> slots_;
+  std::vector<const void*> group_metas_;
+  std::vector<std::size_t> group_sizes_;
+  const void* last_meta_ = nullptr;
+  std::size_t last_group_ = npos;
+};
+
+template <class D, class F, class... Args>
+void invoke_batch_impl(std::span<const proxy<F>> proxies, Args&... args) {
+  using O = typename dispatch_traits<D>::template matched_overload<Args&...>;
+  for (std::size_t i = 0u; i < proxies.size();) {
+    const void* meta = proxy_helper<F>::get_meta(proxies[i]);
+    if (meta == nullptr) {
+      ++i;
+      continue;
+    }
+    auto dispatcher = proxy_helper<F>::template get_dispatcher<D, O>(
+        proxies[i]);
+    do {
+      overload_traits<O>::call(
+          dispatcher, proxy_helper<F>::get_ptr(proxies[i]), args...);
+    } while (++i < proxies.size() &&
+        proxy_helper<F>::get_meta(proxies[i]) == meta);
+  }
+}
+
+template <class D, class F, class... Args>
+void invoke_batch_unordered_impl(std::span<const proxy<F>> proxies,
+    Args&... args) {
+  using O = typename dispatch_traits<D>::template matched_overload<Args&...>;
+  meta_grouping grouping;
+  std::vector<std::size_t> groups(proxies.size());
+  for (std::size_t i = 0u; i < proxies.size(); ++i) {
+    const void* meta = proxy_helper<F>::get_meta(proxies[i]);
+    groups[i] = meta == nullptr ? meta_grouping::npos :
+        grouping.group_of(meta);
+  }
+  std::vector<std::size_t> offsets(grouping.group_count() + 1u, 0u);
+  for (std::size_t g = 0u; g < grouping.group_count(); ++g) {
+    offsets[g + 1u] = offsets[g] + grouping.group_size(g);
+  }
+  std::vector<const proxy<F>*> ordered(offsets.back());
+  std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0u; i < proxies.size(); ++i) {
+    if (groups[i] != meta_grouping::npos) {
+      ordered[cursors[groups[i]]++] = &proxies[i];
+    }
+  }
+  for (std::size_t g = 0u; g < grouping.group_count(); ++g) {
+    auto dispatcher = proxy_helper<F>::template get_dispatcher<D, O>(
+        *ordered[offsets[g]]);
+    for (std::size_t i = offsets[g]; i < offsets[g + 1u]; ++i) {
+      overload_traits<O>::call(
+          dispatcher, proxy_helper<F>::get_ptr(*ordered[i]), args...);
+    }
+  }
+}
+
+template <class D, class F, class... Args>
+void invoke_bulk_impl(std::span<const proxy<F>> proxies, Args&... args) {
+  using O = typename dispatch_traits<D>::template matched_overload<Args&...>;
+  using Bulk = typename dispatch_traits<D>::bulk;
+  for (std::size_t i = 0u; i < proxies.size();) {
+    const void* meta = proxy_helper<F>::get_meta(proxies[i]);
+    if (meta == nullptr) {
+      ++i;
+      continue;
+    }
+    std::size_t end = i + 1u;
+    while (end < proxies.size() &&
+        proxy_helper<F>::get_meta(proxies[end]) == meta) {
+      ++end;
+    }
+    const Bulk& bulk =
+        proxy_helper<F>::template get_dispatch_meta<D>(proxies[i]);
+    auto fn = static_cast<const bulk_overload_meta<O>&>(bulk).bulk_dispatcher;
+    if (fn == nullptr) {
+      auto dispatcher = proxy_helper<F>::template get_dispatcher<D, O>(
+          proxies[i]);
+      for (; i < end; ++i) {
+        overload_traits<O>::call(
+            dispatcher, proxy_helper<F>::get_ptr(proxies[i]), args...);
+      }
+      continue;
+    }
+    // A single call finds each run of consecutive objects
+    while (i < end) {
+      void* first;
+      std::size_t count = bulk.run_accessor(proxy_helper<F>::get_ptr(
+          proxies[i]), sizeof(proxy<F>), end - i, &first);
+      overload_traits<O>::bulk_call(fn, first, count, args...);
+      i += count;
+    }
+  }
+}
+
+}  // namespace details
+
+// Invokes D on every nonempty proxy in order, loading the dispatcher once per
+// run of consecutive proxies that share a meta table
+template <class D, class F, std::size_t N, class... Args>
+void invoke_batch(std::span<const proxy<F>, N> proxies, Args&&... args)
+    requires(requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_batch_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+template <class D, class F, std::size_t N, class... Args>
+void invoke_batch(std::span<proxy<F>, N> proxies, Args&&... args)
+    requires(requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_batch_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+
+// Invokes D on every nonempty proxy grouped by meta table, so that each group
+// is processed through a single dispatcher. The order of invocation is
+// unspecified.
+template <class D, class F, std::size_t N, class... Args>
+void invoke_batch_unordered(std::span<const proxy<F>, N> proxies,
+    Args&&... args)
+    requires(requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_batch_unordered_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+template <class D, class F, std::size_t N, class... Args>
+void invoke_batch_unordered(std::span<proxy<F>, N> proxies, Args&&... args)
+    requires(requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_batch_unordered_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+
+// Same as invoke_batch(), except that the bulk dispatch D receives each run
+// of proxies that share a meta table and refer to contiguous objects (e.g.,
+// pointers into the same array) as a single span. Finding a run takes one
+// indirect call rather than one per proxy
+template <class D, class F, std::size_t N, class... Args>
+void invoke_bulk(std::span<const proxy<F>, N> proxies, Args&&... args)
+    requires(details::dispatch_traits<D>::bulk::applicable &&
+        requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_bulk_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+template <class D, class F, std::size_t N, class... Args>
+void invoke_bulk(std::span<proxy<F>, N> proxies, Args&&... args)
+    requires(details::dispatch_traits<D>::bulk::applicable &&
+        requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+  details::invoke_bulk_impl<D, F>(
+      std::span<const proxy<F>>{proxies}, args...);
+}
+
+namespace details {
+
+struct segment_clear_dispatch {
+  using overload_types = std::tuple<void() noexcept>;
+  template <class T>
+  void operator()(std::vector<T>& self) const noexcept { self.clear(); }
+};
+struct segment_facade {
+  using dispatch_types = std::tuple<segment_clear_dispatch>;
+  static constexpr proxiable_ptr_constraints constraints{
+    .max_size = sizeof(std::vector<char>),
+    .max_align = alignof(std::vector<char>),
+    .copyability = constraint_level::none,
+    .relocatability = constraint_level::nothrow,
+    .destructibility = constraint_level::nothrow,
+  };
+  using reflection_type = void;
+};
+
+// Dense IDs of the element types of poly_vector, in order of first use
+inline std::size_t next_segment_type_id() noexcept {
+  static std::atomic<std::size_t> counter{0u};
+  return counter.fetch_add(1u, std::memory_order_relaxed);
+}
+template <class T>
+std::size_t segment_type_id() noexcept {
+  static const std::size_t result = next_segment_type_id();
+  return result;
+}
+
+}  // namespace details
+
+// Stores objects of each concrete type contiguously in a segment of its own,
+// so that invoke_each() calls a single dispatcher per segment over
+// consecutive elements. Elements are visited segment by segment.
+template <facade F>
+class poly_vector {
+  using DefaultDispatch =
+      typename details::basic_facade_traits<F>::default_dispatch;
+  template <class T>
+  using SegmentPtr = details::sbo_ptr<std::vector<T>>;
+
+  struct segment {
+    // A proxy of a null T*, whose dispatchers serve every element of the
+    // segment
+    proxy<F> prototype;
+    proxy<details::segment_facade> elements;
+    std::size_t element_size;
+    proxy<F> (*make_element_proxy)(void*);
+    // The data and size of elements, updated whenever elements changes
+    char* data = nullptr;
+    std::size_t size = 0u;
+  };
+
+ public:
+  poly_vector() = default;
+  poly_vector(poly_vector&&) noexcept = default;
+  poly_vector& operator=(poly_vector&&) noexcept = default;
+
+  template <class T, class... Args>
+  T& emplace_back(Args&&... args)
+      requires(proxiable<T*, F> && std::is_constructible_v<T, Args...> &&
+          std::is_move_constructible_v<T>) {
+    segment& s = get_segment<T>();
+    std::vector<T>& elements = get_elements<T>(s);
+    T& result = elements.emplace_back(std::forward<Args>(args)...);
+    s.data = reinterpret_cast<char*>(elements.data());
+    s.size = elements.size();
+    return result;
+  }
+  template <class T>
+  std::decay_t<T>& push_back(T&& value)
+      requires(proxiable<std::decay_t<T>*, F> &&
+          std::is_constructible_v<std::decay_t<T>, T> &&
+          std::is_move_constructible_v<std::decay_t<T>>)
+      { return emplace_back<std::decay_t<T>>(std::forward<T>(value)); }
+
+  std::size_t size() const noexcept {
+    std::size_t result = 0u;
+    for (const segment& s : segments_) {
+      result += s.size;
+    }
+    return result;
+  }
+  bool empty() const noexcept { return size() == 0u; }
+  std::size_t segment_count() const noexcept { return segments_.size(); }
+  void clear() noexcept {
+    for (segment& s : segments_) {
+      s.elements.template invoke<details::segment_clear_dispatch>();
+      s.size = 0u;
+    }
+  }
+  template <class T>
+  std::span<T> segment_of() noexcept requires(proxiable<T*, F>) {
+    segment* s = find_segment<T>();
+    if (s == nullptr) {
+      return {};
+    }
+    return std::span<T>{reinterpret_cast<T*>(s->data), s->size};
+  }
+
+  template <class D = DefaultDispatch, class... Args>
+  void invoke_each(Args&&... args) const
+      requires(requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+    using O = typename details::dispatch_traits<D>::template matched_overload<
+        Args&...>;
+    for (const segment& s : segments_) {
+      auto dispatcher = details::proxy_helper<F>::template get_dispatcher<D, O>(
+          s.prototype);
+      char* data = s.data;
+      for (std::size_t i = 0u; i < s.size; ++i, data += s.element_size) {
+        // The storage of a proxy of T* is the pointer itself
+        void* ptr = data;
+        details::overload_traits<O>::call(
+            dispatcher, reinterpret_cast<const char*>(&ptr), args...);
+      }
+    }
+  }
+  // Calls the bulk dispatch D once per segment with a span of its elements
+  template <class D, class... Args>
+  void invoke_bulk(Args&&... args) const
+      requires(details::dispatch_traits<D>::bulk::applicable &&
+          requires(const proxy<F>& p) { p.template invoke<D>(args...); }) {
+    using O = typename details::dispatch_traits<D>::template matched_overload<
+        Args&...>;
+    for (const segment& s : segments_) {
+      auto fn = static_cast<const details::bulk_overload_meta<O>&>(
+          details::proxy_helper<F>::template get_dispatch_meta<D>(
+              s.prototype)).bulk_dispatcher;
+      if (fn != nullptr) {
+        details::overload_traits<O>::bulk_call(fn, s.data, s.size, args...);
+        continue;
+      }
+      // Falls back to per-element calls when the type lacks a bulk overload
+      auto dispatcher = details::proxy_helper<F>::template get_dispatcher<D, O>(
+          s.prototype);
+      char* data = s.data;
+      for (std::size_t i = 0u; i < s.size; ++i, data += s.element_size) {
+        void* ptr = data;
+        details::overload_traits<O>::call(
+            dispatcher, reinterpret_cast<const char*>(&ptr), args...);
+      }
+    }
+  }
+  template <class Fn>
+  void for_each(Fn&& fn) const requires(std::is_invocable_v<Fn&, proxy<F>>) {
+    for (const segment& s : segments_) {
+      char* data = s.data;
+      for (std::size_t i = 0u; i < s.size; ++i, data += s.element_size) {
+        fn(s.make_element_proxy(data));
+      }
+    }
+  }
+
+ private:
+  // Segments are indexed by the ID of their element type, so that finding
+  // one takes no search
+  template <class T>
+  segment* find_segment() noexcept {
+    std::size_t id = details::segment_type_id<T>();
+    if (id >= index_.size() || index_[id] == 0u) {
+      return nullptr;
+    }
+    return &segments_[index_[id] - 1u];
+  }
+  template <class T>
+  static std::vector<T>& get_elements(segment& s) noexcept
+      { return *s.elements.template target<SegmentPtr<T>>()->operator->(); }
+  template <class T>
+  segment& get_segment() {
+    segment* s = find_segment<T>();
+    if (s != nullptr) {
+      return *s;
+    }
+    std::size_t id = details::segment_type_id<T>();
+    if (id >= index_.size()) {
+      index_.resize(id + 1u, 0u);
+    }
+    segment& result = segments_.emplace_back(segment{
+        static_cast<T*>(nullptr),
+        proxy<details::segment_facade>{std::in_place_type<SegmentPtr<T>>},
+        sizeof(T),
+        [](void* ptr) -> proxy<F> { return static_cast<T*>(ptr); }});
+    index_[id] = segments_.size();
+    return result;
+  }
+
+  std::vector<segment> segments_;
+  // One plus the position in segments_ of the segment of each type ID, or 0
+  std::vector<std::size_t> index_;
+};
+
 // The following types and macros aim to simplify definition of dispatch and
 // facade types prior to C++26
 namespace details {
 
-template <class Args>
+template <class Args, bool RV>
 struct overload_matching_helper {
   template <class O, class I> struct reduction : std::type_identity<O> {};
   template <class O, class I>
       requires(std::is_same_v<
-          typename overload_traits<I>::forwarding_argument_types, Args>)
+          typename overload_traits<I>::forwarding_argument_types, Args> &&
+          overload_traits<I>::is_rvalue == RV)
   struct reduction<O, I> : std::type_identity<I> {};
 };
-template <class Args, class... Os>
-    requires(!std::is_void_v<recursive_reduction_t<
-        overload_matching_helper<Args>::template reduction, void, Os...>>)
-using matched_overload = recursive_reduction_t<
-    overload_matching_helper<Args>::template reduction, void, Os...>;
-template <class Args, class... Os>
+template <class T, class Args, class... Os>
+    requires(!std::is_void_v<recursive_reduction_t<overload_matching_helper<
+        Args, std::is_rvalue_reference_v<T&&>>::template reduction, void,
+        Os...>>)
+using matched_overload = recursive_reduction_t<overload_matching_helper<
+    Args, std::is_rvalue_reference_v<T&&>>::template reduction, void, Os...>;
+template <class T, class Args, class... Os>
 constexpr bool matched_overload_is_noexcept =
-    overload_traits<matched_overload<Args, Os...>>::is_noexcept;
+    overload_traits<matched_overload<T, Args, Os...>>::is_noexcept;
 
 template <class O, class I> struct flat_reduction : std::type_identity<O> {};
 template <class... Os, class I> requires(!std::is_same_v<I, Os> && ...)
@@ -645,6 +2876,14 @@ struct overloads_reduction<O, I>
 
 template <class... Os> requires(sizeof...(Os) > 0u)
 struct dispatch_prototype { using overload_types = std::tuple<Os...>; };
+template <class T>
+struct field_prototype {
+  using field_type = T;
+  using overload_types = std::tuple<T() noexcept>;
+};
+template <class... Os> requires(sizeof...(Os) > 0u)
+struct bulk_dispatch_prototype : dispatch_prototype<Os...>
+    { static constexpr bool is_bulk_dispatch = true; };
 template <class... Ds> requires(sizeof...(Ds) > 0u)
 struct combined_dispatch_prototype : Ds... {
   using overload_types = recursive_reduction_t<
@@ -652,48 +2891,271 @@ struct combined_dispatch_prototype : Ds... {
   using Ds::operator()...;
 };
 template <class Ds = std::tuple<>, proxiable_ptr_constraints C =
-    relocatable_ptr_constraints, class R = void>
+    relocatable_ptr_constraints, class R = void,
+    facade_options O = facade_options{}>
 struct facade_prototype {
   using dispatch_types = typename flat_reduction<std::tuple<>, Ds>::type;
   static constexpr proxiable_ptr_constraints constraints = C;
   using reflection_type = R;
+  static constexpr facade_options options = O;
 };
 
+constexpr std::size_t cache_line_size = 64u;
+
 }  // namespace details
 
+// Bounded single-producer single-consumer queue of which the slots are
+// proxies. Producers construct the object directly in a slot, and consumers
+// invoke it in place or relocate it out
+template <facade F>
+class spsc_proxy_queue {
+ public:
+  explicit spsc_proxy_queue(std::size_t capacity)
+      : mask_(std::bit_ceil(capacity < 2u ? 2u : capacity) - 1u),
+        slots_(new proxy<F>[mask_ + 1u]) {}
+  spsc_proxy_queue(const spsc_proxy_queue&) = delete;
+  spsc_proxy_queue& operator=(const spsc_proxy_queue&) = delete;
+
+  std::size_t capacity() const noexcept { return mask_ + 1u; }
+  template <class P, class... Args>
+  bool try_emplace(Args&&... args) requires(requires(proxy<F>& p)
+      { p.template emplace<P>(std::forward<Args>(args)...); }) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_].template emplace<P>(std::forward<Args>(args)...);
+    tail_.store(tail + 1u, std::memory_order_release);
+    return true;
+  }
+  template <class T, class... Args>
+  bool try_make(Args&&... args) {
+    return try_emplace<details::make_proxy_ptr<F, T>>(
+        std::forward<Args>(args)...);
+  }
+  template <class Fn>
+  bool try_consume(Fn&& fn) requires(std::is_invocable_v<Fn, proxy<F>&>) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return false;
+      }
+    }
+    proxy<F>& slot = slots_[head & mask_];
+    try {
+      std::invoke(std::forward<Fn>(fn), slot);
+    } catch (...) {
+      release(slot, head);
+      throw;
+    }
+    release(slot, head);
+    return true;
+  }
+  bool try_pop(proxy<F>& out)
+      { return try_consume([&](proxy<F>& p) { out = std::move(p); }); }
+
+ private:
+  void release(proxy<F>& slot, std::size_t head) noexcept {
+    slot.reset();
+    head_.store(head + 1u, std::memory_order_release);
+  }
+
+  const std::size_t mask_;
+  const std::unique_ptr<proxy<F>[]> slots_;
+  alignas(details::cache_line_size) std::atomic<std::size_t> tail_{0u};
+  std::size_t head_cache_ = 0u;
+  alignas(details::cache_line_size) std::atomic<std::size_t> head_{0u};
+  std::size_t tail_cache_ = 0u;
+};
+
+// Same as spsc_proxy_queue, except that any number of threads may produce
+// and consume. Each slot carries a sequence number that tells which lap of
+// producers or consumers may claim it next. A slot of which the construction
+// threw is published empty and skipped by consumers
+template <facade F>
+class mpmc_proxy_queue {
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    proxy<F> value;
+  };
+
+ public:
+  explicit mpmc_proxy_queue(std::size_t capacity)
+      : mask_(std::bit_ceil(capacity < 2u ? 2u : capacity) - 1u),
+        cells_(new cell[mask_ + 1u]) {
+    for (std::size_t i = 0u; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  mpmc_proxy_queue(const mpmc_proxy_queue&) = delete;
+  mpmc_proxy_queue& operator=(const mpmc_proxy_queue&) = delete;
+
+  std::size_t capacity() const noexcept { return mask_ + 1u; }
+  template <class P, class... Args>
+  bool try_emplace(Args&&... args) requires(requires(proxy<F>& p)
+      { p.template emplace<P>(std::forward<Args>(args)...); }) {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    cell* c = claim(enqueue_pos_, pos, 0u);
+    if (c == nullptr) {
+      return false;
+    }
+    try {
+      c->value.template emplace<P>(std::forward<Args>(args)...);
+    } catch (...) {
+      c->sequence.store(pos + 1u, std::memory_order_release);
+      throw;
+    }
+    c->sequence.store(pos + 1u, std::memory_order_release);
+    return true;
+  }
+  template <class T, class... Args>
+  bool try_make(Args&&... args) {
+    return try_emplace<details::make_proxy_ptr<F, T>>(
+        std::forward<Args>(args)...);
+  }
+  // Relocates value into the queue, or leaves it untouched and returns false
+  // if the queue is full
+  bool try_push(proxy<F>& value) noexcept requires(
+      F::constraints.relocatability >= constraint_level::nothrow) {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    cell* c = claim(enqueue_pos_, pos, 0u);
+    if (c == nullptr) {
+      return false;
+    }
+    c->value = std::move(value);
+    c->sequence.store(pos + 1u, std::memory_order_release);
+    return true;
+  }
+  template <class Fn>
+  bool try_consume(Fn&& fn) requires(std::is_invocable_v<Fn, proxy<F>&>) {
+    for (;;) {
+      std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+      cell* c = claim(dequeue_pos_, pos, 1u);
+      if (c == nullptr) {
+        return false;
+      }
+      if (c->value.has_value()) {
+        try {
+          std::invoke(std::forward<Fn>(fn), c->value);
+        } catch (...) {
+          release(*c, pos);
+          throw;
+        }
+        release(*c, pos);
+        return true;
+      }
+      release(*c, pos);
+    }
+  }
+  bool try_pop(proxy<F>& out)
+      { return try_consume([&](proxy<F>& p) { out = std::move(p); }); }
+
+ private:
+  // Claims the cell at pos of which the sequence is pos + lag, or returns
+  // null if the queue is full (for producers) or empty (for consumers)
+  cell* claim(std::atomic<std::size_t>& cursor, std::size_t& pos,
+      std::size_t lag) noexcept {
+    for (;;) {
+      cell* c = &cells_[pos & mask_];
+      std::size_t sequence = c->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + lag));
+      if (diff == 0) {
+        if (cursor.compare_exchange_weak(pos, pos + 1u,
+            std::memory_order_relaxed)) {
+          return c;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        pos = cursor.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  void release(cell& c, std::size_t pos) noexcept {
+    c.value.reset();
+    c.sequence.store(pos + mask_ + 1u, std::memory_order_release);
+  }
+
+  const std::size_t mask_;
+  const std::unique_ptr<cell[]> cells_;
+  alignas(details::cache_line_size) std::atomic<std::size_t> enqueue_pos_{0u};
+  alignas(details::cache_line_size) std::atomic<std::size_t> dequeue_pos_{0u};
+};
+
 }  // namespace pro
 
 #define PRO_DEF_MEMBER_DISPATCH(NAME, ...) \
     struct NAME : ::pro::details::dispatch_prototype<__VA_ARGS__> { \
       template <class __T, class... __Args> \
-      decltype(auto) operator()(__T& __self, __Args&&... __args) \
+      decltype(auto) operator()(__T&& __self, __Args&&... __args) \
           noexcept(::pro::details::matched_overload_is_noexcept< \
-              std::tuple<__Args&&...>, __VA_ARGS__>) \
+              __T, std::tuple<__Args&&...>, __VA_ARGS__>) \
           requires( \
               requires{ \
                 typename ::pro::details::matched_overload< \
-                    std::tuple<__Args&&...>, __VA_ARGS__>; \
-                __self.NAME(std::forward<__Args>(__args)...); \
+                    __T, std::tuple<__Args&&...>, __VA_ARGS__>; \
+                std::forward<__T>(__self).NAME( \
+                    std::forward<__Args>(__args)...); \
               } && (!::pro::details::matched_overload_is_noexcept< \
-                  std::tuple<__Args&&...>, __VA_ARGS__> || \
-              noexcept(__self.NAME(std::forward<__Args>(__args)...)))) \
-          { return __self.NAME(std::forward<__Args>(__args)...); } \
+                  __T, std::tuple<__Args&&...>, __VA_ARGS__> || \
+              noexcept(std::forward<__T>(__self).NAME( \
+                  std::forward<__Args>(__args)...)))) { \
+        return std::forward<__T>(__self).NAME( \
+            std::forward<__Args>(__args)...); \
+      } \
     }
 #define PRO_DEF_FREE_DISPATCH(NAME, FUNC, ...) \
     struct NAME : ::pro::details::dispatch_prototype<__VA_ARGS__> { \
       template <class __T, class... __Args> \
-      decltype(auto) operator()(__T& __self, __Args&&... __args) \
+      decltype(auto) operator()(__T&& __self, __Args&&... __args) \
           noexcept(::pro::details::matched_overload_is_noexcept< \
-              std::tuple<__Args&&...>, __VA_ARGS__>) \
+              __T, std::tuple<__Args&&...>, __VA_ARGS__>) \
           requires( \
               requires{ \
                 typename ::pro::details::matched_overload< \
-                    std::tuple<__Args&&...>, __VA_ARGS__>; \
-                FUNC(__self, std::forward<__Args>(__args)...); \
+                    __T, std::tuple<__Args&&...>, __VA_ARGS__>; \
+                FUNC(std::forward<__T>(__self), \
+                    std::forward<__Args>(__args)...); \
               } && (!::pro::details::matched_overload_is_noexcept< \
-                  std::tuple<__Args&&...>, __VA_ARGS__> || \
-              noexcept(FUNC(__self, std::forward<__Args>(__args)...)))) \
-          { return FUNC(__self, std::forward<__Args>(__args)...); } \
+                  __T, std::tuple<__Args&&...>, __VA_ARGS__> || \
+              noexcept(FUNC(std::forward<__T>(__self), \
+                  std::forward<__Args>(__args)...)))) { \
+        return FUNC(std::forward<__T>(__self), \
+            std::forward<__Args>(__args)...); \
+      } \
+    }
+#define PRO_DEF_BULK_DISPATCH(NAME, FUNC, ...) \
+    struct NAME : ::pro::details::bulk_dispatch_prototype<__VA_ARGS__> { \
+      template <class __T, class... __Args> \
+      void operator()(__T& __self, __Args&&... __args) \
+          noexcept(noexcept(FUNC(::std::span<__T>{&__self, 1u}, \
+              std::forward<__Args>(__args)...))) \
+          requires(requires { FUNC(::std::span<__T>{&__self, 1u}, \
+              std::forward<__Args>(__args)...); }) \
+          { FUNC(::std::span<__T>{&__self, 1u}, \
+              std::forward<__Args>(__args)...); } \
+      template <class __T, class... __Args> \
+      static void bulk(::std::span<__T> __objects, __Args&&... __args) \
+          noexcept(noexcept(FUNC(__objects, std::forward<__Args>(__args)...))) \
+          requires(requires { \
+              FUNC(__objects, std::forward<__Args>(__args)...); }) \
+          { FUNC(__objects, std::forward<__Args>(__args)...); } \
+    }
+#define PRO_DEF_MEMBER_FIELD(NAME, TYPE) \
+    struct NAME : ::pro::details::field_prototype<TYPE> { \
+      template <class __T> \
+      TYPE operator()(const __T& __self) const noexcept \
+          requires(requires { __self.NAME; }) \
+          { return __self.NAME; } \
+      template <class __T> \
+      static consteval std::size_t offset_of() noexcept \
+          requires(std::is_standard_layout_v<__T> && \
+              ::pro::details::is_field_of<decltype(&__T::NAME), TYPE>::value) \
+          { return offsetof(__T, NAME); } \
     }
 #define PRO_DEF_COMBINED_DISPATCH(NAME, ...) \
     struct NAME : ::pro::details::combined_dispatch_prototype<__VA_ARGS__> {}
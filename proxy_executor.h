@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef _MSFT_PROXY_EXECUTOR_
+#define _MSFT_PROXY_EXECUTOR_
+
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "proxy.h"
+
+namespace pro {
+
+namespace details {
+
+struct task_call : dispatch_prototype<void()> {
+  template <class T>
+  void operator()(T& self) requires(std::is_invocable_v<T&>)
+      { std::invoke(self); }
+};
+
+// Bounded Chase-Lev work-stealing deque of proxies. Only the owner pushes and
+// pops at the bottom, while other threads steal from the top. Tasks stay in
+// their slots and are relocated out by whichever thread takes them, so a
+// thief claims the top before relocating, and marks the slot free afterwards
+// so that the owner does not reuse it meanwhile
+template <facade F>
+class chase_lev_deque {
+  struct slot {
+    proxy<F> value;
+    std::atomic<bool> busy{false};
+  };
+
+ public:
+  explicit chase_lev_deque(std::size_t capacity)
+      : mask_(static_cast<std::int64_t>(
+            std::bit_ceil(capacity < 2u ? 2u : capacity)) - 1),
+        slots_(new slot[static_cast<std::size_t>(mask_) + 1u]) {}
+  chase_lev_deque(const chase_lev_deque&) = delete;
+  chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+  // Relocates value into the deque, or leaves it untouched and returns false
+  // if the deque is full
+  bool try_push(proxy<F>& value) noexcept {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    slot& s = at(b);
+    if (b - t > mask_ || s.busy.load(std::memory_order_acquire)) {
+      return false;
+    }
+    s.value = std::move(value);
+    s.busy.store(true, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+  bool pop(proxy<F>& item) noexcept {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_seq_cst);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    if (t == b) {
+      bool won = top_.compare_exchange_strong(t, t + 1,
+          std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return false;
+      }
+    }
+    take(at(b), item);
+    return true;
+  }
+  bool steal(proxy<F>& item) noexcept {
+    std::int64_t t = top_.load(std::memory_order_seq_cst);
+    std::int64_t b = bottom_.load(std::memory_order_seq_cst);
+    if (t >= b || !top_.compare_exchange_strong(t, t + 1,
+        std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return false;
+    }
+    take(at(t), item);
+    return true;
+  }
+
+ private:
+  slot& at(std::int64_t i) const noexcept
+      { return slots_[static_cast<std::size_t>(i & mask_)]; }
+  static void take(slot& s, proxy<F>& item) noexcept {
+    item = std::move(s.value);
+    s.busy.store(false, std::memory_order_release);
+  }
+
+  const std::int64_t mask_;
+  const std::unique_ptr<slot[]> slots_;
+  alignas(cache_line_size) std::atomic<std::int64_t> top_{0};
+  alignas(cache_line_size) std::atomic<std::int64_t> bottom_{0};
+};
+
+}  // namespace details
+
+// Move-only void() callables, of which those no larger than seven pointers
+// are stored in place
+struct task_facade : details::facade_prototype<details::task_call,
+    proxiable_ptr_constraints{
+      .max_size = 7u * sizeof(void*),
+      .max_align = alignof(void*),
+      .copyability = constraint_level::none,
+      .relocatability = constraint_level::nothrow,
+      .destructibility = constraint_level::nothrow,
+    }> {};
+
+// Runs tasks on a fixed set of worker threads. A task submitted from a
+// worker is pushed to the deque of that worker, from which idle workers
+// steal; other submissions go through a shared lock-free queue. Queues are
+// bounded and hold the proxies themselves: a worker runs a task it submits
+// when both its deque and the shared queue are full, while other threads
+// wait for room. Tasks must not throw. The destructor waits for all tasks,
+// including those submitted meanwhile
+template <facade F = task_facade>
+    requires(F::constraints.relocatability >= constraint_level::nothrow)
+class task_executor {
+ public:
+  static constexpr std::size_t deque_capacity = 1024u;
+  static constexpr std::size_t shared_capacity = 4096u;
+
+  explicit task_executor(
+      std::size_t thread_count = std::thread::hardware_concurrency())
+      : workers_(thread_count == 0u ? 1u : thread_count),
+        shared_tasks_(shared_capacity) {
+    for (std::size_t i = 0u; i < workers_.size(); ++i) {
+      workers_[i].thread = std::thread{[this, i] { run_worker(i); }};
+    }
+  }
+  task_executor(const task_executor&) = delete;
+  ~task_executor() {
+    wait_idle();
+    {
+      std::lock_guard lock{sleep_mutex_};
+      stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (worker& w : workers_) {
+      w.thread.join();
+    }
+  }
+  task_executor& operator=(const task_executor&) = delete;
+
+  std::size_t thread_count() const noexcept { return workers_.size(); }
+  void submit(proxy<F> task) {
+    pending_.fetch_add(1u, std::memory_order_relaxed);
+    worker* w = current_worker();
+    if (w != nullptr && w->owner == this) {
+      if (!w->tasks.try_push(task) && !shared_tasks_.try_push(task)) {
+        run(task);
+        return;
+      }
+    } else {
+      while (!shared_tasks_.try_push(task)) {
+        std::this_thread::yield();
+      }
+    }
+    signal_.fetch_add(1u, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0u) {
+      std::lock_guard lock{sleep_mutex_};
+      sleep_cv_.notify_one();
+    }
+  }
+  template <class T>
+  void submit(T&& callable) requires(!std::is_same_v<std::decay_t<T>,
+      proxy<F>> && proxiable<details::deep_ptr<std::decay_t<T>>, F>)
+      { submit(make_proxy<F>(std::forward<T>(callable))); }
+  void wait_idle() const noexcept {
+    std::size_t pending = pending_.load(std::memory_order_acquire);
+    while (pending != 0u) {
+      pending_.wait(pending, std::memory_order_acquire);
+      pending = pending_.load(std::memory_order_acquire);
+    }
+  }
+
+ private:
+  struct worker {
+    details::chase_lev_deque<F> tasks{deque_capacity};
+    std::thread thread;
+    task_executor* owner = nullptr;
+    std::uint64_t seed = 0u;
+  };
+
+  static worker*& current_worker() noexcept {
+    thread_local worker* result = nullptr;
+    return result;
+  }
+
+  void run_worker(std::size_t index) {
+    worker& self = workers_[index];
+    self.owner = this;
+    self.seed = index * 0x9e3779b97f4a7c15u + 1u;
+    current_worker() = &self;
+    proxy<F> task;
+    for (;;) {
+      std::uint64_t signal = signal_.load(std::memory_order_seq_cst);
+      if (self.tasks.pop(task) || shared_tasks_.try_pop(task) ||
+          steal(self, task)) {
+        run(task);
+        continue;
+      }
+      std::unique_lock lock{sleep_mutex_};
+      sleepers_.fetch_add(1u, std::memory_order_seq_cst);
+      sleep_cv_.wait(lock, [&] {
+        return stopping_ || signal_.load(std::memory_order_seq_cst) != signal;
+      });
+      sleepers_.fetch_sub(1u, std::memory_order_relaxed);
+      if (stopping_) {
+        break;
+      }
+    }
+    current_worker() = nullptr;
+  }
+  // Invokes and destroys the task, which is then no longer pending
+  void run(proxy<F>& task) {
+    task();
+    task.reset();
+    if (pending_.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+      pending_.notify_all();
+    }
+  }
+  bool steal(worker& self, proxy<F>& task) {
+    std::size_t n = workers_.size();
+    self.seed ^= self.seed << 13;
+    self.seed ^= self.seed >> 7;
+    self.seed ^= self.seed << 17;
+    std::size_t start = static_cast<std::size_t>(self.seed % n);
+    for (std::size_t i = 0u; i < n; ++i) {
+      worker& victim = workers_[(start + i) % n];
+      if (&victim != &self && victim.tasks.steal(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<worker> workers_;
+  mpmc_proxy_queue<F> shared_tasks_;
+  mutable std::atomic<std::size_t> pending_{0u};
+  std::atomic<std::uint64_t> signal_{0u};
+  std::atomic<std::size_t> sleepers_{0u};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stopping_ = false;
+};
+
+}  // namespace pro
+
+#endif  // _MSFT_PROXY_EXECUTOR_
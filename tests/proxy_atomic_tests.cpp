@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Value, int() noexcept);
+PRO_DEF_FACADE(Versioned, Value, pro::copyable_ptr_constraints);
+
+}  // namespace poly
+
+class Version {
+ public:
+  Version(int value, std::atomic<int>* alive) : value_(value), alive_(alive)
+      { alive_->fetch_add(1, std::memory_order_relaxed); }
+  Version(const Version& rhs) : Version(rhs.value_, rhs.alive_) {}
+  ~Version() { alive_->fetch_sub(1, std::memory_order_relaxed); }
+  int Value() const noexcept { return value_; }
+
+ private:
+  int value_;
+  std::atomic<int>* alive_;
+};
+
+}  // namespace
+
+TEST(ProxyAtomicTests, TestStoreAndInvoke) {
+  std::atomic<int> alive = 0;
+  {
+    pro::atomic_proxy<poly::Versioned> p;
+    ASSERT_FALSE(p.has_value());
+    p.store(pro::make_proxy<poly::Versioned, Version>(1, &alive));
+    ASSERT_TRUE(p.has_value());
+    ASSERT_EQ(p(), 1);
+    p.store(pro::make_proxy<poly::Versioned, Version>(2, &alive));
+    ASSERT_EQ(p.invoke<poly::Value>(), 2);
+    int before_load = alive.load();
+    pro::proxy<poly::Versioned> snapshot = p.load();
+    ASSERT_EQ(snapshot(), 2);
+    ASSERT_EQ(alive.load(), before_load + 1);
+    p.reset();
+    ASSERT_FALSE(p.has_value());
+    ASSERT_FALSE(p.load().has_value());
+  }
+  ASSERT_EQ(alive.load(), 0);
+}
+
+TEST(ProxyAtomicTests, TestBatchedReclamation) {
+  constexpr int kThreshold = static_cast<int>(pro::details::epoch_domain::reclaim_threshold);
+  std::atomic<int> alive = 0;
+  {
+    pro::atomic_proxy<poly::Versioned> p;
+    for (int i = 0; i < kThreshold * 4; ++i) {
+      p.store(pro::make_proxy<poly::Versioned, Version>(i, &alive));
+      ASSERT_LE(alive.load(), kThreshold + 1);
+    }
+    ASSERT_EQ(p(), kThreshold * 4 - 1);
+  }
+  ASSERT_EQ(alive.load(), 0);
+}
+
+TEST(ProxyAtomicTests, TestReclamationOnThreadExit) {
+  std::atomic<int> alive = 0;
+  {
+    pro::atomic_proxy<poly::Versioned> p;
+    std::thread writer{[&] {
+      for (int i = 0; i < 8; ++i) {
+        p.store(pro::make_proxy<poly::Versioned, Version>(i, &alive));
+      }
+    }};
+    writer.join();
+    ASSERT_EQ(alive.load(), 1);
+    ASSERT_EQ(p(), 7);
+  }
+  ASSERT_EQ(alive.load(), 0);
+}
+
+TEST(ProxyAtomicTests, TestConcurrentReload) {
+  constexpr int kReaders = 4;
+  constexpr int kVersions = 2000;
+  std::atomic<int> alive = 0;
+  std::atomic<bool> failed = false;
+  {
+    pro::atomic_proxy<poly::Versioned> p{
+        pro::make_proxy<poly::Versioned, Version>(0, &alive)};
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+      readers.emplace_back([&] {
+        int last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+          int value = p();
+          if (value < last) { failed.store(true); }
+          last = value;
+        }
+      });
+    }
+    for (int i = 1; i <= kVersions; ++i) {
+      p.store(pro::make_proxy<poly::Versioned, Version>(i, &alive));
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& t : readers) { t.join(); }
+    ASSERT_EQ(p(), kVersions);
+  }
+  ASSERT_FALSE(failed.load());
+  ASSERT_EQ(alive.load(), 0);
+}
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include <gtest/gtest.h>
+#include <memory_resource>
+#include <thread>
 #include "proxy.h"
 #include "utils.h"
 
@@ -29,9 +31,77 @@ PRO_DEF_FACADE(TestSmallStringable, utils::poly::ToString, pro::proxiable_ptr_co
     .destructibility = pro::constraint_level::nothrow,
   }, SboObserver);
 PRO_DEF_FACADE(TestLargeStringable, utils::poly::ToString, pro::copyable_ptr_constraints, SboObserver);
+PRO_DEF_FACADE(TestWeakStringable, utils::poly::ToString, pro::copyable_ptr_constraints, void, pro::facade_options{.weak_references = true});
+PRO_DEF_MEMBER_DISPATCH(push_back, void(int));
+PRO_DEF_MEMBER_DISPATCH(size, std::size_t() noexcept);
+PRO_DEF_FACADE(TestCowContainer, PRO_MAKE_DISPATCH_PACK(push_back, size), pro::copyable_ptr_constraints);
+PRO_DEF_FACADE(TestViewableCowContainer, PRO_MAKE_DISPATCH_PACK(push_back, size), pro::copyable_ptr_constraints, void,
+    pro::facade_options{.proxy_views = true});
+PRO_DEF_MEMBER_DISPATCH(Compare, bool(int, int));
+PRO_DEF_FACADE(TestStatelessComparator, Compare, pro::proxiable_ptr_constraints{
+    .max_size = 0u,
+    .max_align = alignof(void*),
+    .copyability = pro::constraint_level::nontrivial,
+    .relocatability = pro::constraint_level::nothrow,
+    .destructibility = pro::constraint_level::nothrow,
+  });
 
 }  // namespace poly
 
+template <class T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+
+  explicit CountingAllocator(int* counter) noexcept : counter_(counter) {}
+  template <class U>
+  CountingAllocator(const CountingAllocator<U>& rhs) noexcept : counter_(rhs.counter_) {}
+
+  T* allocate(std::size_t n) {
+    ++*counter_;
+    return std::allocator<T>{}.allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    --*counter_;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+ private:
+  template <class> friend class CountingAllocator;
+
+  int* counter_;
+};
+
+class CopyCountingVector {
+ public:
+  explicit CopyCountingVector(int* copies) noexcept : copies_(copies) {}
+  CopyCountingVector(const CopyCountingVector& rhs) : data_(rhs.data_), copies_(rhs.copies_) { ++*copies_; }
+
+  void push_back(int value) { data_.push_back(value); }
+  std::size_t size() const noexcept { return data_.size(); }
+
+ private:
+  std::vector<int> data_;
+  int* copies_;
+};
+
+struct Less {
+  bool Compare(int a, int b) const noexcept { return a < b; }
+};
+
+struct CountedGreater {
+  static inline int constructions = 0;
+
+  CountedGreater() noexcept { ++constructions; }
+  CountedGreater(const CountedGreater&) noexcept { ++constructions; }
+  bool Compare(int a, int b) const noexcept { return a > b; }
+};
+
+struct DestructibleLess {
+  ~DestructibleLess() {}
+  bool Compare(int a, int b) const noexcept { return a < b; }
+};
+
 }  // namespace
 
 TEST(ProxyCreationTests, TestMakeProxy_WithSBO_FromValue) {
@@ -205,3 +275,262 @@ TEST(ProxyCreationTests, TestMakeProxy_WithoutSBO_Lifetime_Move) {
   expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
   ASSERT_TRUE(tracker.GetOperations() == expected_ops);
 }
+
+TEST(ProxyCreationTests, TestAllocateProxy_Lifetime_Copy) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  int allocations = 0;
+  {
+    auto p1 = pro::allocate_proxy<poly::TestLargeStringable, utils::LifetimeTracker::Session>(CountingAllocator<void>{&allocations}, &tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    ASSERT_EQ(allocations, 1);
+    ASSERT_FALSE(p1.reflect().SboEnabled);
+    auto p2 = p1;
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kCopyConstruction);
+    ASSERT_EQ(allocations, 2);
+    ASSERT_EQ(p2.invoke(), "Session 2");
+    auto p3 = std::move(p1);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_EQ(allocations, 2);
+    ASSERT_EQ(p3.invoke(), "Session 1");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  ASSERT_EQ(allocations, 0);
+}
+
+TEST(ProxyCreationTests, TestAllocateProxy_MemoryResource) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  alignas(std::max_align_t) char buffer[256];
+  std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+  {
+    auto p1 = pro::allocate_proxy<poly::TestLargeStringable, utils::LifetimeTracker::Session>(&resource, &tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    auto p2 = p1;
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kCopyConstruction);
+    ASSERT_EQ(p1.invoke(), "Session 1");
+    ASSERT_EQ(p2.invoke(), "Session 2");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyCreationTests, TestAllocateProxy_Exception) {
+  utils::LifetimeTracker tracker;
+  int allocations = 0;
+  tracker.ThrowOnNextConstruction();
+  bool exception_thrown = false;
+  try {
+    pro::allocate_proxy<poly::TestLargeStringable, utils::LifetimeTracker::Session>(CountingAllocator<void>{&allocations}, &tracker);
+  } catch (const utils::ConstructionFailure&) {
+    exception_thrown = true;
+  }
+  ASSERT_TRUE(exception_thrown);
+  ASSERT_EQ(allocations, 0);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyPooled_WithSBO) {
+  utils::LifetimeTracker tracker;
+  pro::pool_statistics before = pro::get_pool_statistics();
+  {
+    auto p = pro::make_proxy_pooled<poly::TestLargeStringable, utils::LifetimeTracker::Session>(&tracker);
+    ASSERT_TRUE(p.reflect().SboEnabled);
+    ASSERT_EQ(p.invoke(), "Session 1");
+  }
+  pro::pool_statistics after = pro::get_pool_statistics();
+  ASSERT_EQ(after.allocations, before.allocations);
+  ASSERT_EQ(after.deallocations, before.deallocations);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyPooled_WithoutSBO) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  pro::pool_statistics before = pro::get_pool_statistics();
+  {
+    auto p1 = pro::make_proxy_pooled<poly::TestSmallStringable, utils::LifetimeTracker::Session>(&tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    ASSERT_FALSE(p1.reflect().SboEnabled);
+    auto p2 = p1;
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kCopyConstruction);
+    ASSERT_EQ(p1.invoke(), "Session 1");
+    ASSERT_EQ(p2.invoke(), "Session 2");
+    ASSERT_EQ(pro::get_pool_statistics().allocations, before.allocations + 2);
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  pro::pool_statistics after = pro::get_pool_statistics();
+  ASSERT_EQ(after.deallocations, before.deallocations + 2);
+  ASSERT_EQ(after.remote_deallocations, before.remote_deallocations);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyPooled_CrossThread) {
+  utils::LifetimeTracker tracker;
+  std::vector<pro::proxy<poly::TestSmallStringable>> proxies;
+  std::thread producer{[&] {
+    for (int i = 0; i < 100; ++i) {
+      proxies.push_back(pro::make_proxy_pooled<poly::TestSmallStringable, utils::LifetimeTracker::Session>(&tracker));
+    }
+  }};
+  producer.join();
+  ASSERT_EQ(proxies[99].invoke(), "Session 100");
+  pro::pool_statistics before = pro::get_pool_statistics();
+  proxies.clear();
+  pro::pool_statistics after = pro::get_pool_statistics();
+  ASSERT_EQ(after.deallocations, before.deallocations + 100);
+  ASSERT_EQ(after.remote_deallocations, before.remote_deallocations + 100);
+  ASSERT_EQ(tracker.GetOperations().size(), 200u);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_Lifetime) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    auto p1 = pro::make_proxy_shared<poly::TestSmallStringable, utils::LifetimeTracker::Session>(&tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    ASSERT_FALSE(p1.reflect().SboEnabled);
+    auto p2 = p1;
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    {
+      auto p3 = std::move(p1);
+      ASSERT_FALSE(p1.has_value());
+      ASSERT_EQ(p3.invoke(), "Session 1");
+    }
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_NonAtomic) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    auto p1 = pro::make_proxy_shared<poly::TestSmallStringable, utils::LifetimeTracker::Session, pro::refcount_policy::nonatomic>({1, 2, 3}, &tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kInitializerListConstruction);
+    std::vector<pro::proxy<poly::TestSmallStringable>> copies(3u, p1);
+    p1.reset();
+    ASSERT_EQ(copies[2].invoke(), "Session 1");
+    copies.pop_back();
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_Weak) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  pro::weak_proxy<poly::TestWeakStringable> w1;
+  ASSERT_TRUE(w1.expired());
+  ASSERT_FALSE(w1.lock().has_value());
+  {
+    auto p1 = pro::make_proxy_shared<poly::TestWeakStringable, utils::LifetimeTracker::Session>(&tracker);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    w1 = p1;
+    auto w2 = w1;
+    ASSERT_FALSE(w2.expired());
+    auto p2 = w2.lock();
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    ASSERT_EQ(pro::details::proxy_helper<poly::TestWeakStringable>::get_meta(p2), pro::details::proxy_helper<poly::TestWeakStringable>::get_meta(p1));
+    p1.reset();
+    ASSERT_FALSE(w1.expired());
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  ASSERT_TRUE(w1.expired());
+  ASSERT_FALSE(w1.lock().has_value());
+  w1.reset();
+  ASSERT_TRUE(w1.expired());
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_WeakCountOptIn) {
+  auto p1 = pro::make_proxy_shared<poly::TestSmallStringable, int>(1);
+  ASSERT_TRUE((p1.has_type<pro::details::shared_compact_ptr<int, pro::refcount_policy::atomic, false>>()));
+  auto p2 = pro::make_proxy_shared<poly::TestWeakStringable, int>(2);
+  ASSERT_TRUE((p2.has_type<pro::details::shared_compact_ptr<int, pro::refcount_policy::atomic, true>>()));
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_WeakFromUnshared) {
+  auto p = pro::make_proxy<poly::TestWeakStringable>(123);
+  pro::weak_proxy<poly::TestWeakStringable> w = p;
+  ASSERT_TRUE(w.expired());
+  ASSERT_FALSE(w.lock().has_value());
+}
+
+TEST(ProxyCreationTests, TestMakeProxyShared_WeakLockRace) {
+  constexpr int kRounds = 1000;
+  for (int i = 0; i < kRounds; ++i) {
+    auto p = pro::make_proxy_shared<poly::TestWeakStringable, int>(i);
+    pro::weak_proxy<poly::TestWeakStringable> w = p;
+    std::thread t{[&] { p.reset(); }};
+    auto locked = w.lock();
+    if (locked.has_value()) {
+      ASSERT_EQ(locked.invoke(), std::to_string(i));
+    }
+    t.join();
+    locked.reset();
+    ASSERT_TRUE(w.expired());
+  }
+}
+
+TEST(ProxyCreationTests, TestMakeProxyCow) {
+  int copies = 0;
+  auto p1 = pro::make_proxy_cow<poly::TestCowContainer, CopyCountingVector>(&copies);
+  p1.invoke<poly::push_back>(1);
+  auto p2 = p1;
+  auto p3 = p1;
+  ASSERT_EQ(p2.invoke<poly::size>(), 1u);
+  ASSERT_EQ(copies, 0);
+  p2.invoke<poly::push_back>(2);
+  ASSERT_EQ(copies, 1);
+  p2.invoke<poly::push_back>(3);
+  ASSERT_EQ(copies, 1);
+  ASSERT_EQ(p1.invoke<poly::size>(), 1u);
+  ASSERT_EQ(p2.invoke<poly::size>(), 3u);
+  p3.reset();
+  p1.invoke<poly::push_back>(4);
+  ASSERT_EQ(copies, 1);
+  ASSERT_EQ(p1.invoke<poly::size>(), 2u);
+}
+
+TEST(ProxyCreationTests, TestMakeProxyCow_View) {
+  int copies = 0;
+  auto p1 = pro::make_proxy_cow<poly::TestViewableCowContainer, CopyCountingVector>(&copies);
+  auto p2 = p1;
+  pro::proxy_view<poly::TestViewableCowContainer> view = p2;
+  ASSERT_EQ(copies, 1);
+  view.invoke<poly::push_back>(1);
+  ASSERT_EQ(p1.invoke<poly::size>(), 0u);
+  ASSERT_EQ(p2.invoke<poly::size>(), 1u);
+}
+
+TEST(ProxyCreationTests, TestMakeProxy_Stateless) {
+  static_assert(sizeof(pro::proxy<poly::TestStatelessComparator>) == sizeof(void*));
+  static_assert(pro::proxiable<pro::details::sbo_ptr<Less>, poly::TestStatelessComparator>);
+  static_assert(!pro::proxiable<Less*, poly::TestStatelessComparator>);
+  static_assert(!pro::proxiable<pro::details::sbo_ptr<DestructibleLess>, poly::TestStatelessComparator>);
+  auto p1 = pro::make_proxy<poly::TestStatelessComparator, Less>();
+  ASSERT_TRUE(p1.has_type<pro::details::sbo_ptr<Less>>());
+  ASSERT_TRUE(p1.invoke<poly::Compare>(1, 2));
+  {
+    auto p2 = pro::make_proxy<poly::TestStatelessComparator, CountedGreater>();
+    auto p3 = p2;
+    ASSERT_EQ(CountedGreater::constructions, 2);
+    ASSERT_TRUE(p3.invoke<poly::Compare>(2, 1));
+    swap(p1, p3);
+    ASSERT_FALSE(p1.invoke<poly::Compare>(1, 2));
+    ASSERT_TRUE(p3.invoke<poly::Compare>(1, 2));
+    auto p4 = std::move(p1);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_FALSE(p4.invoke<poly::Compare>(1, 2));
+  }
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "proxy_executor.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_FREE_DISPATCH(Call, std::invoke, void());
+PRO_DEF_FACADE(RelocatableTask, Call);
+PRO_DEF_FACADE(AddressCachingTask, Call, pro::relocatable_ptr_constraints, void, pro::facade_options{.cache_address = true});
+
+}  // namespace poly
+
+static_assert(sizeof(pro::proxy<pro::task_facade>) == 8u * sizeof(void*));
+
+template <class F>
+struct Spawn {
+  void operator()() const {
+    if (depth == 0) {
+      leaves->fetch_add(1, std::memory_order_relaxed);
+    } else {
+      executor->submit(Spawn{executor, depth - 1, leaves});
+      executor->submit(Spawn{executor, depth - 1, leaves});
+    }
+  }
+
+  pro::task_executor<F>* executor;
+  int depth;
+  std::atomic<int>* leaves;
+};
+
+// Not trivially relocatable with libstdc++, but small enough to be stored in
+// place in a proxy of task_facade
+struct LabeledSpawn {
+  void operator()() const {
+    if (depth == 0) {
+      labels->fetch_add(label.size(), std::memory_order_relaxed);
+    } else {
+      executor->submit(LabeledSpawn{executor, depth - 1, labels, label});
+      executor->submit(LabeledSpawn{executor, depth - 1, labels, label});
+    }
+  }
+
+  pro::task_executor<>* executor;
+  int depth;
+  std::atomic<std::size_t>* labels;
+  std::string label;
+};
+
+struct ThrowingCopy {
+  ThrowingCopy() = default;
+  ThrowingCopy(const ThrowingCopy&) { throw std::runtime_error{"copy"}; }
+  ThrowingCopy(ThrowingCopy&&) noexcept = default;
+  void operator()() const {}
+};
+
+}  // namespace
+
+TEST(ProxyExecutorTests, TestSubmitFromOutside) {
+  std::atomic<int> sum = 0;
+  pro::task_executor<> executor{4u};
+  ASSERT_EQ(executor.thread_count(), 4u);
+  for (int i = 1; i <= 1000; ++i) {
+    executor.submit([&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+  }
+  executor.wait_idle();
+  ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(ProxyExecutorTests, TestSubmitFromWorkers) {
+  std::atomic<int> leaves = 0;
+  {
+    pro::task_executor<> executor{4u};
+    executor.submit(Spawn<pro::task_facade>{&executor, 12, &leaves});
+  }
+  ASSERT_EQ(leaves.load(), 1 << 12);
+}
+
+TEST(ProxyExecutorTests, TestAddressCachingTasks) {
+  std::atomic<int> leaves = 0;
+  pro::task_executor<poly::AddressCachingTask> executor{3u};
+  executor.submit(Spawn<poly::AddressCachingTask>{&executor, 10, &leaves});
+  executor.wait_idle();
+  ASSERT_EQ(leaves.load(), 1 << 10);
+}
+
+TEST(ProxyExecutorTests, TestNontriviallyRelocatableTasks) {
+  std::atomic<std::size_t> labels = 0u;
+  std::atomic<int> leaves = 0;
+  {
+    pro::task_executor<> executor{3u};
+    pro::proxy<pro::task_facade> task = pro::make_proxy<pro::task_facade>(LabeledSpawn{&executor, 10, &labels, "label"});
+    ASSERT_TRUE(task.has_type<pro::details::sbo_ptr<LabeledSpawn>>());
+    executor.submit(std::move(task));
+    pro::task_executor<poly::RelocatableTask> relocatable_executor{2u};
+    relocatable_executor.submit(Spawn<poly::RelocatableTask>{&relocatable_executor, 8, &leaves});
+  }
+  ASSERT_EQ(labels.load(), 5u << 10);
+  ASSERT_EQ(leaves.load(), 1 << 8);
+}
+
+TEST(ProxyExecutorTests, TestTaskLifetime) {
+  auto token = std::make_shared<std::string>("token");
+  std::atomic<std::size_t> length = 0u;
+  {
+    pro::task_executor<> executor{2u};
+    for (int i = 0; i < 100; ++i) {
+      executor.submit([token, &length] { length.fetch_add(token->size()); });
+    }
+    executor.wait_idle();
+    ASSERT_EQ(token.use_count(), 1);
+  }
+  ASSERT_EQ(length.load(), 500u);
+}
+
+TEST(ProxyExecutorTests, TestSubmitBeyondCapacity) {
+  constexpr int kCount = static_cast<int>(pro::task_executor<>::deque_capacity + pro::task_executor<>::shared_capacity) * 2;
+  std::atomic<int> sum = 0;
+  {
+    pro::task_executor<> executor{2u};
+    executor.submit([&] {
+      for (int i = 0; i < kCount; ++i) {
+        executor.submit([&sum] { sum.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+    for (int i = 0; i < kCount; ++i) {
+      executor.submit([&sum] { sum.fetch_add(1, std::memory_order_relaxed); });
+    }
+  }
+  ASSERT_EQ(sum.load(), kCount * 2);
+}
+
+TEST(ProxyExecutorTests, TestThrowingSubmission) {
+  pro::task_executor<> executor{2u};
+  ThrowingCopy callable;
+  ASSERT_THROW(executor.submit(callable), std::runtime_error);
+  executor.wait_idle();
+}
@@ -3,16 +3,30 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <list>
 #include <ranges>
+#include <span>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
 #include <vector>
 #include "proxy.h"
+#include "utils.h"
 
 namespace {
 
+std::vector<std::size_t> scaled_runs;
+
+template <class T>
+void ScaleAll(std::span<T> values, int factor) {
+  scaled_runs.push_back(values.size());
+  for (T& value : values) {
+    value *= factor;
+  }
+}
+
 namespace poly {
 
 template <class... Os>
@@ -41,14 +55,65 @@ struct Append {
   }
 };
 
+PRO_DEF_MEMBER_DISPATCH(Drain, std::vector<int>() &&);
+PRO_DEF_FACADE(Drainable, Drain);
+
+template <class T>
+std::vector<int> TakePayloadImpl(T&& self) { return std::forward<T>(self).payload; }
+PRO_DEF_FREE_DISPATCH(TakePayload, TakePayloadImpl, std::vector<int>(), std::vector<int>() &&);
+PRO_DEF_FACADE(PayloadOwner, TakePayload);
+
+PRO_DEF_MEMBER_FIELD(id, int);
+PRO_DEF_MEMBER_FIELD(priority, double);
+PRO_DEF_FACADE(Task, PRO_MAKE_DISPATCH_PACK(id, priority));
+
+PRO_DEF_MEMBER_DISPATCH(push_back, void(int));
+PRO_DEF_FACADE(ViewableContainer, PRO_MAKE_DISPATCH_PACK(GetSize, push_back), pro::relocatable_ptr_constraints, void,
+    pro::facade_options{.proxy_views = true});
+
+PRO_DEF_BULK_DISPATCH(Scale, ScaleAll, void(int factor));
+PRO_DEF_FACADE(Scalable, Scale);
+
 }  // namespace poly
 
+struct Buffer {
+  std::vector<int> Drain() && { return std::move(data); }
+
+  std::vector<int> data;
+};
+
+struct Message {
+  std::vector<int> payload;
+};
+
+struct PlainTask {
+  double priority;
+  int id;
+};
+
+struct PolymorphicTask {
+  virtual ~PolymorphicTask() = default;
+  int id;
+  double priority;
+};
+
+template <class D, class P>
+pro::details::field_access GetFieldAccess() {
+  const typename pro::details::dispatch_traits<D>::meta& meta = pro::details::facade_traits<poly::Task>::meta_storage<P>;
+  return static_cast<const pro::details::field_meta<D>&>(meta).access;
+}
+
 template <class F, class D, bool NE, class... Args>
 concept InvocableWithDispatch =
     requires(const pro::proxy<F> p, Args... args) {
       { p.template invoke<D>(std::forward<Args>(args)...) };
       typename std::enable_if_t<NE == noexcept(p.template invoke<D>(std::forward<Args>(args)...))>;
     };
+template <class F, class D, class... Args>
+concept RvalueInvocableWithDispatch =
+    requires(pro::proxy<F> p, Args... args) {
+      { std::move(p).template invoke<D>(std::forward<Args>(args)...) };
+    };
 template <class F, bool NE, class... Args>
 concept InvocableWithoutDispatch =
   requires(const pro::proxy<F> p, Args... args) {
@@ -98,6 +163,24 @@ TEST(ProxyInvocationTests, TestArgumentForwarding) {
   ASSERT_EQ(result, expected_result);
 }
 
+TEST(ProxyInvocationTests, TestArgumentForwarding_ByValue) {
+  utils::LifetimeTracker tracker;
+  auto f = [](utils::LifetimeTracker::Session) {};
+  pro::proxy<poly::Callable<void(utils::LifetimeTracker::Session)>> p = &f;
+  auto count_ops = [&](utils::LifetimeOperationType type)
+      { return std::ranges::count(tracker.GetOperations(), type, &utils::LifetimeOperation::type_); };
+  {
+    utils::LifetimeTracker::Session session{&tracker};
+    p(std::move(session));  // Moved once into the parameter of the callee
+    ASSERT_EQ(count_ops(utils::LifetimeOperationType::kCopyConstruction), 0);
+    ASSERT_EQ(count_ops(utils::LifetimeOperationType::kMoveConstruction), 1);
+    p(session);  // Copied before the call and moved into the parameter
+    ASSERT_EQ(count_ops(utils::LifetimeOperationType::kCopyConstruction), 1);
+    ASSERT_EQ(count_ops(utils::LifetimeOperationType::kMoveConstruction), 2);
+  }
+  ASSERT_EQ(count_ops(utils::LifetimeOperationType::kDestruction), 4);
+}
+
 TEST(ProxyInvocationTests, TestThrow) {
   const char* expected_error_message = "My exception";
   auto f = [&] { throw std::runtime_error{ expected_error_message }; };
@@ -214,3 +297,323 @@ TEST(ProxyInvocationTests, TestCombinationWithIncompleteDispatch) {
     ASSERT_TRUE(exception_thrown);
   }
 }
+
+TEST(ProxyInvocationTests, TestInlineDispatch) {
+  PRO_DEF_FACADE(InlineCallable, poly::Call<int(int), int(double)>, pro::copyable_ptr_constraints, void, pro::facade_options{.inline_dispatch = true});
+  static_assert(sizeof(pro::proxy<InlineCallable>) == sizeof(pro::proxy<poly::Callable<int(int), int(double)>>) + sizeof(void*) * 2u);
+  int offset = 10;
+  auto p = pro::make_proxy<InlineCallable>([offset](auto x) { return offset + static_cast<int>(x); });
+  ASSERT_EQ(p(1), 11);
+  ASSERT_EQ(p(2.5), 12);
+  auto p2 = p;
+  ASSERT_EQ(p2(3), 13);
+  auto p3 = std::move(p);
+  ASSERT_FALSE(p.has_value());
+  ASSERT_EQ(p3(4), 14);
+  p3 = pro::make_proxy<InlineCallable>([](auto x) { return static_cast<int>(x) * 2; });
+  ASSERT_EQ(p3(5), 10);
+  swap(p2, p3);
+  ASSERT_EQ(p2(6), 12);
+  ASSERT_EQ(p3(6), 16);
+}
+
+TEST(ProxyInvocationTests, TestInlineDispatch_Trivial) {
+  PRO_DEF_FACADE(InlineTrivialCallable, poly::Call<int()>, pro::trivial_ptr_constraints, void, pro::facade_options{.inline_dispatch = true});
+  static_assert(std::is_trivially_copy_constructible_v<pro::proxy<InlineTrivialCallable>>);
+  auto f1 = [] { return 1; };
+  auto f2 = [] { return 2; };
+  pro::proxy<InlineTrivialCallable> p1 = &f1;
+  pro::proxy<InlineTrivialCallable> p2 = &f2;
+  swap(p1, p2);
+  ASSERT_EQ(p1(), 2);
+  ASSERT_EQ(p2(), 1);
+}
+
+TEST(ProxyInvocationTests, TestCachedAddress) {
+  PRO_DEF_FACADE(CachedCallable, poly::Call<int(int), int(double)>, pro::copyable_ptr_constraints, void, pro::facade_options{.cache_address = true});
+  static_assert(sizeof(pro::proxy<CachedCallable>) == sizeof(pro::proxy<poly::Callable<int(int), int(double)>>) + sizeof(void*));
+  int offset = 10;
+  auto p = pro::make_proxy<CachedCallable>([offset](auto x) { return offset + static_cast<int>(x); });
+  ASSERT_EQ(p(1), 11);
+  ASSERT_EQ(p(2.5), 12);
+  auto p2 = p;  // The object is stored in place, so that the cached address is updated
+  p.reset();
+  ASSERT_EQ(p2(3), 13);
+  auto p3 = std::move(p2);
+  ASSERT_FALSE(p2.has_value());
+  ASSERT_EQ(p3(4), 14);
+  p2 = std::make_shared<std::function<int(double)>>([](double x) { return static_cast<int>(x) * 2; });
+  ASSERT_EQ(p2(5), 10);
+  swap(p2, p3);
+  ASSERT_EQ(p2(6), 16);
+  ASSERT_EQ(p3(6), 12);
+}
+
+TEST(ProxyInvocationTests, TestCachedAddress_InlineDispatch) {
+  PRO_DEF_FACADE(CachedInlineIterable, PRO_MAKE_DISPATCH_PACK(poly::ForEach<int>, poly::GetSize), pro::trivial_ptr_constraints, void,
+      pro::facade_options{.inline_dispatch = true, .cache_address = true});
+  static_assert(!std::is_trivially_copy_constructible_v<pro::proxy<CachedInlineIterable>>);
+  std::list<int> l1{1, 2, 3};
+  std::vector<int> l2{4, 5};
+  pro::proxy<CachedInlineIterable> p1 = &l1;
+  pro::proxy<CachedInlineIterable> p2 = &l2;
+  swap(p1, p2);
+  ASSERT_EQ(p1.invoke<poly::GetSize>(), 2u);
+  ASSERT_EQ(p2.invoke<poly::GetSize>(), 3u);
+  auto p3 = p1;
+  int sum = 0;
+  auto accumulate_sum = [&](int x) { sum += x; };
+  p3.invoke<poly::ForEach<int>>(&accumulate_sum);
+  ASSERT_EQ(sum, 9);
+}
+
+TEST(ProxyInvocationTests, TestHotColdMetaLayout) {
+  PRO_DEF_FACADE(HotIterable, PRO_MAKE_DISPATCH_PACK(poly::ForEach<int>, poly::GetSize), pro::copyable_ptr_constraints, void,
+      pro::facade_options{.separate_cold_meta = true, .meta_alignment = 64u});
+  using Traits = pro::details::facade_traits<HotIterable>;
+  using ColdMeta = typename pro::details::basic_facade_traits<HotIterable>::cold_meta;
+  static_assert(sizeof(Traits::meta) == sizeof(void*) * 3u);
+  static_assert(Traits::meta_alignment == 64u);
+  const auto* meta = &Traits::meta_storage<std::list<int>*>;
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(meta) % 64u, 0u);
+  ASSERT_EQ(static_cast<const void*>(static_cast<const pro::details::dispatch_traits<poly::ForEach<int>>::meta*>(meta)), static_cast<const void*>(meta));
+  ASSERT_EQ(meta->cold, (&pro::details::cold_meta_storage<ColdMeta, std::list<int>*>));
+
+  std::list<int> l = { 1, 2, 3 };
+  pro::proxy<HotIterable> p = &l;
+  auto p2 = p;
+  ASSERT_EQ(p2.invoke<poly::GetSize>(), 3);
+  int sum = 0;
+  auto accumulate_sum = [&](int x) { sum += x; };
+  p.invoke<poly::ForEach<int>>(&accumulate_sum);
+  ASSERT_EQ(sum, 6);
+  auto p3 = std::move(p);
+  ASSERT_FALSE(p.has_value());
+  ASSERT_EQ(p3.invoke<poly::GetSize>(), 3);
+}
+
+TEST(ProxyInvocationTests, TestDispatchFirstMetaLayout) {
+  PRO_DEF_FACADE(HotIterable, PRO_MAKE_DISPATCH_PACK(poly::GetSize, poly::ForEach<int>), pro::copyable_ptr_constraints, void,
+      pro::facade_options{.dispatch_first = true});
+  using Traits = pro::details::facade_traits<HotIterable>;
+  static_assert(sizeof(Traits::meta) == sizeof(pro::details::facade_traits<poly::Iterable<int>>::meta) + sizeof(void*));
+  const auto* meta = &Traits::meta_storage<std::list<int>*>;
+  ASSERT_EQ(static_cast<const void*>(static_cast<const pro::details::dispatch_traits<poly::GetSize>::meta*>(meta)), static_cast<const void*>(meta));
+  std::list<int> l = { 1, 2, 3 };
+  pro::proxy<HotIterable> p = &l;
+  auto p2 = p;
+  ASSERT_EQ(p2.invoke<poly::GetSize>(), 3);
+}
+
+TEST(ProxyInvocationTests, TestInvokeBatch) {
+  std::vector<int> side_effect;
+  auto f1 = [&](int x) { side_effect.push_back(x); };
+  auto f2 = [&](int x) { side_effect.push_back(x * 10); };
+  std::vector<pro::proxy<poly::Callable<void(int)>>> ps;
+  ps.emplace_back(&f1);
+  ps.emplace_back(&f1);
+  ps.emplace_back(&f2);
+  ps.emplace_back();
+  ps.emplace_back(&f1);
+  pro::invoke_batch<poly::Call<void(int)>>(std::span{ps}, 2);
+  ASSERT_EQ(side_effect, (std::vector<int>{2, 2, 20, 2}));
+}
+
+TEST(ProxyInvocationTests, TestInvokeBulk) {
+  scaled_runs.clear();
+  int values[] = {1, 2, 3, 4};
+  double ratio = 1.5;
+  std::vector<pro::proxy<poly::Scalable>> ps;
+  ps.emplace_back(&values[0]);
+  ps.emplace_back(&values[1]);
+  ps.emplace_back(&values[2]);
+  ps.emplace_back();
+  ps.emplace_back(&values[3]);
+  ps.emplace_back(&values[0]);
+  ps.emplace_back(&ratio);
+  ps.emplace_back(&ratio);
+  pro::invoke_bulk<poly::Scale>(std::span{ps}, 10);
+  ASSERT_EQ(scaled_runs, (std::vector<std::size_t>{3u, 1u, 1u, 1u, 1u}));
+  ASSERT_EQ(values[0], 100);
+  ASSERT_EQ(values[3], 40);
+  ASSERT_EQ(ratio, 150.0);
+  ps[1].invoke<poly::Scale>(2);
+  ASSERT_EQ(values[1], 40);
+  ASSERT_EQ(scaled_runs.back(), 1u);
+}
+
+TEST(ProxyInvocationTests, TestInvokeBulk_MergedRuns) {
+  scaled_runs.clear();
+  std::vector<int> values(1000, 1);
+  std::vector<pro::proxy<poly::Scalable>> ps;
+  for (int& value : values) {
+    ps.emplace_back(&value);
+  }
+  pro::invoke_bulk<poly::Scale>(std::span{ps}, 3);
+  ASSERT_EQ(scaled_runs, std::vector<std::size_t>{1000u});
+  std::swap(ps[400], ps[600]);
+  pro::invoke_bulk<poly::Scale>(std::span{ps}, 2);
+  ASSERT_EQ(scaled_runs, (std::vector<std::size_t>{1000u, 400u, 1u, 199u, 1u, 399u}));
+  ASSERT_EQ(values[0], 6);
+  ASSERT_EQ(values[400], 6);
+  ASSERT_EQ(values[999], 6);
+}
+
+TEST(ProxyInvocationTests, TestInvokeBatchUnordered) {
+  std::vector<int> side_effect;
+  auto f1 = [&](int x) { side_effect.push_back(x); };
+  auto f2 = [&](int x) { side_effect.push_back(x * 10); };
+  auto f3 = [&](int x) { side_effect.push_back(x * 100); };
+  std::vector<pro::proxy<poly::Callable<void(int)>>> ps;
+  for (int i = 0; i < 100; ++i) {
+    switch (i % 4) {
+      case 0: ps.emplace_back(&f1); break;
+      case 1: ps.emplace_back(&f2); break;
+      case 2: ps.emplace_back(&f3); break;
+      default: ps.emplace_back(); break;
+    }
+  }
+  const auto& cps = ps;
+  pro::invoke_batch_unordered<poly::Call<void(int)>>(std::span{cps}, 1);
+  ASSERT_EQ(side_effect.size(), 75u);
+  ASSERT_EQ(std::ranges::count(side_effect, 1), 25);
+  ASSERT_EQ(std::ranges::count(side_effect, 10), 25);
+  ASSERT_EQ(std::ranges::count(side_effect, 100), 25);
+  for (std::size_t i = 1u; i < side_effect.size(); ++i) {
+    if (side_effect[i] != side_effect[i - 1u]) {
+      ASSERT_EQ(i % 25u, 0u);  // Invocations are grouped by type
+    }
+  }
+}
+
+TEST(ProxyInvocationTests, TestProxyView_FromProxy) {
+  PRO_DEF_FACADE(ViewableIterable, PRO_MAKE_DISPATCH_PACK(poly::ForEach<int>, poly::GetSize), pro::relocatable_ptr_constraints, void,
+      pro::facade_options{.proxy_views = true});
+  static_assert(std::is_trivially_copyable_v<pro::proxy_view<ViewableIterable>>);
+  static_assert(sizeof(pro::proxy_view<ViewableIterable>) == sizeof(void*) * 2u);
+  static_assert(!std::is_constructible_v<pro::proxy_view<poly::Iterable<int>>, const pro::proxy<poly::Iterable<int>>&>);
+  static_assert(sizeof(pro::details::facade_traits<ViewableIterable>::meta) ==
+      sizeof(pro::details::facade_traits<poly::Iterable<int>>::meta) + sizeof(void*));
+  std::list<int> l{1, 2, 3};
+  pro::proxy<ViewableIterable> p = &l;
+  pro::proxy_view<ViewableIterable> v = p;
+  ASSERT_TRUE(v.has_value());
+  ASSERT_EQ(v.invoke<poly::GetSize>(), 3u);
+  int sum = 0;
+  auto accumulate_sum = [&](int x) { sum += x; };
+  v.invoke<poly::ForEach<int>>(&accumulate_sum);
+  ASSERT_EQ(sum, 6);
+  ASSERT_FALSE(pro::proxy_view<ViewableIterable>{pro::proxy<ViewableIterable>{}}.has_value());
+}
+
+TEST(ProxyInvocationTests, TestProxyView_FromReference) {
+  std::vector<int> v{1, 2};
+  pro::proxy_view<poly::Container<int>> view = v;
+  auto p = view.invoke<poly::Append<int>>(3);
+  ASSERT_EQ(p.invoke<poly::GetSize>(), 3u);
+  ASSERT_EQ(v.size(), 3u);
+}
+
+TEST(ProxyInvocationTests, TestProxyView_FromOwningProxy) {
+  pro::proxy<poly::ViewableContainer> owner = std::make_unique<std::vector<int>>();
+  pro::proxy_view<poly::ViewableContainer> view = owner;
+  view.invoke<poly::push_back>(4);
+  ASSERT_EQ(owner.invoke<poly::GetSize>(), 1u);
+}
+
+TEST(ProxyInvocationTests, TestProxyView_DefaultDispatch) {
+  PRO_DEF_FACADE(ViewableCallable, poly::Call<int(int)>, pro::copyable_ptr_constraints, void, pro::facade_options{.proxy_views = true});
+  auto f = [](int x) { return x * 2; };
+  pro::proxy<ViewableCallable> p = &f;
+  pro::proxy_view<ViewableCallable> v = p;
+  ASSERT_EQ(v(21), 42);
+  pro::proxy_view<poly::Callable<int(int)>> w = f;
+  ASSERT_EQ(w(4), 8);
+}
+
+TEST(ProxyInvocationTests, TestInvokeLikely) {
+  auto f1 = [](int x) { return x + 1; };
+  auto f2 = [](int x) { return x * 2; };
+  auto f3 = [](int x) { return x - 3; };
+  using Expected = decltype(&f1);
+  std::vector<pro::proxy<poly::Callable<int(int)>>> ps;
+  ps.emplace_back(&f1);
+  ps.emplace_back(&f2);
+  ps.emplace_back(&f3);
+  ps.emplace_back(&f1);
+  pro::likely_counter counter;
+  std::vector<int> results;
+  for (auto& p : ps) {
+    results.push_back(p.invoke_likely<Expected>(counter, 10));
+  }
+  ASSERT_EQ(results, (std::vector<int>{11, 20, 7, 11}));
+  ASSERT_EQ(counter.hits.load(), 2u);
+  ASSERT_EQ(counter.misses.load(), 2u);
+  ASSERT_EQ(ps[1].invoke_likely<Expected>(5), 10);
+}
+
+TEST(ProxyInvocationTests, TestInvokeLikely_MultipleTypes) {
+  std::list<int> l{1, 2};
+  std::vector<int> v{1, 2, 3};
+  std::deque<int> d{1};
+  using Expected = std::tuple<std::list<int>*, std::vector<int>*>;
+  pro::likely_counter counter;
+  pro::proxy<poly::Iterable<int>> p = &l;
+  ASSERT_EQ((p.invoke_likely<Expected, poly::GetSize>(counter)), 2u);
+  p = &v;
+  ASSERT_EQ((p.invoke_likely<Expected, poly::GetSize>(counter)), 3u);
+  p = &d;
+  ASSERT_EQ((p.invoke_likely<Expected, poly::GetSize>(counter)), 1u);
+  ASSERT_EQ(counter.hits.load(), 2u);
+  ASSERT_EQ(counter.misses.load(), 1u);
+  static_assert(noexcept(p.invoke_likely<Expected, poly::GetSize>()));
+}
+
+TEST(ProxyInvocationTests, TestMemberField) {
+  PlainTask plain{2.5, 1};
+  PolymorphicTask polymorphic;
+  polymorphic.id = 3;
+  polymorphic.priority = 0.5;
+  std::vector<pro::proxy<poly::Task>> ps;
+  ps.push_back(pro::make_proxy<poly::Task>(PlainTask{1.5, 4}));
+  ps.push_back(&plain);
+  ps.push_back(&polymorphic);
+  ps.push_back(std::make_unique<PlainTask>(PlainTask{3.5, 2}));
+  std::ranges::sort(ps, {}, [](const auto& p) { return p.template invoke<poly::id>(); });
+  std::vector<int> ids;
+  std::vector<double> priorities;
+  for (const auto& p : ps) {
+    ids.push_back(p.invoke<poly::id>());
+    priorities.push_back(p.invoke<poly::priority>());
+  }
+  ASSERT_EQ(ids, (std::vector<int>{1, 2, 3, 4}));
+  ASSERT_EQ(priorities, (std::vector<double>{2.5, 3.5, 0.5, 1.5}));
+  static_assert(noexcept(ps[0].invoke<poly::id>()));
+  ASSERT_EQ((GetFieldAccess<poly::id, pro::details::sbo_ptr<PlainTask>>()), pro::details::field_access::direct);
+  ASSERT_EQ((GetFieldAccess<poly::id, PlainTask*>()), pro::details::field_access::indirect);
+  ASSERT_EQ((GetFieldAccess<poly::id, PolymorphicTask*>()), pro::details::field_access::dispatch);
+  ASSERT_EQ((GetFieldAccess<poly::id, std::unique_ptr<PlainTask>>()), pro::details::field_access::dispatch);
+  pro::proxy_view<poly::Task> view = plain;
+  ASSERT_EQ(view.invoke<poly::priority>(), 2.5);
+}
+
+TEST(ProxyInvocationTests, TestRvalueDispatch) {
+  static_assert(!InvocableWithDispatch<poly::Drainable, poly::Drain, false>);
+  static_assert(RvalueInvocableWithDispatch<poly::Drainable, poly::Drain>);
+  pro::proxy<poly::Drainable> p = pro::make_proxy<poly::Drainable>(Buffer{{1, 2, 3}});
+  const int* data = p.target<pro::details::deep_ptr<Buffer>>()->operator->()->data.data();
+  std::vector<int> drained = std::move(p).invoke<poly::Drain>();
+  ASSERT_EQ(drained, (std::vector<int>{1, 2, 3}));
+  ASSERT_EQ(drained.data(), data);  // Moved rather than copied
+  ASSERT_TRUE(p.has_value());
+  ASSERT_TRUE(std::move(p)().empty());  // The buffer is left moved-from
+}
+
+TEST(ProxyInvocationTests, TestRvalueDispatch_Overloads) {
+  pro::proxy<poly::PayloadOwner> p = pro::make_proxy<poly::PayloadOwner>(Message{{1, 2}});
+  std::vector<int> copied = p();
+  ASSERT_EQ(copied, (std::vector<int>{1, 2}));
+  std::vector<int> moved = std::move(p)();  // Prefers the overload qualified with &&
+  ASSERT_EQ(moved, (std::vector<int>{1, 2}));
+  ASSERT_TRUE(p().empty());
+}
@@ -9,8 +9,15 @@ namespace {
 
 PRO_DEF_FACADE(TestFacade, utils::poly::ToString, pro::copyable_ptr_constraints);
 
+struct TriviallyRelocatableSession : utils::LifetimeTracker::Session {
+  using Session::Session;
+};
+
 }  // namespace
 
+template <>
+struct pro::is_trivially_relocatable<TriviallyRelocatableSession> : std::true_type {};
+
 TEST(ProxyLifetimeTests, TestDefaultConstrction) {
   pro::proxy<TestFacade> p;
   ASSERT_FALSE(p.has_value());
@@ -838,3 +845,74 @@ TEST(ProxyLifetimeTests, TestSwap_Null_Null) {
   ASSERT_FALSE(p1.has_value());
   ASSERT_FALSE(p2.has_value());
 }
+
+TEST(ProxyLifetimeTests, TestMoveConstrction_TriviallyRelocatable) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    pro::proxy<TestFacade> p1{ std::in_place_type<TriviallyRelocatableSession>, &tracker };
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    auto p2 = std::move(p1);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_TRUE(p2.has_value());
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyLifetimeTests, TestSwap_TriviallyRelocatable) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    pro::proxy<TestFacade> p1{ std::in_place_type<TriviallyRelocatableSession>, &tracker };
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    pro::proxy<TestFacade> p2{ std::in_place_type<TriviallyRelocatableSession>, &tracker };
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kValueConstruction);
+    swap(p1, p2);
+    ASSERT_EQ(p1.invoke(), "Session 2");
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    pro::proxy<TestFacade> p3;
+    swap(p1, p3);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_EQ(p3.invoke(), "Session 2");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyLifetimeTests, TestSwap_TriviallyRelocatable_Self) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    pro::proxy<TestFacade> p{ std::in_place_type<TriviallyRelocatableSession>, &tracker };
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    swap(p, p);
+    ASSERT_EQ(p.invoke(), "Session 1");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyLifetimeTests, TestSwap_TriviallyRelocatable_Null) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    pro::proxy<TestFacade> p1;
+    pro::proxy<TestFacade> p2{ std::in_place_type<TriviallyRelocatableSession>, &tracker };
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    swap(p1, p2);
+    ASSERT_EQ(p1.invoke(), "Session 1");
+    ASSERT_FALSE(p2.has_value());
+    swap(p1, p2);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_EQ(p2.invoke(), "Session 1");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
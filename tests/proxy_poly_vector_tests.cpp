@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+#include <vector>
+#include "proxy.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Update, void(int delta));
+PRO_DEF_MEMBER_DISPATCH(Describe, std::string() noexcept);
+PRO_DEF_FACADE(Entity, PRO_MAKE_DISPATCH_PACK(Update, Describe));
+PRO_DEF_BULK_DISPATCH(Advance, Integrate, void(float dt) noexcept);
+PRO_DEF_MEMBER_FIELD(x, float);
+PRO_DEF_FACADE(Body, PRO_MAKE_DISPATCH_PACK(Advance, x));
+
+}  // namespace poly
+
+struct Particle;
+std::vector<std::size_t> nudged_spans;
+
+namespace poly {
+
+struct Nudge : pro::details::bulk_dispatch_prototype<void(float dx) noexcept> {
+  template <class T>
+  void operator()(T& self, float dx) noexcept { self.x += dx; }
+  static void bulk(std::span<Particle> particles, float dx) noexcept;
+};
+PRO_DEF_FACADE(Nudgeable, PRO_MAKE_DISPATCH_PACK(Nudge, x));
+
+}  // namespace poly
+
+class Walker {
+ public:
+  explicit Walker(int position) : position_(position) {}
+  void Update(int delta) { position_ += delta; }
+  std::string Describe() const noexcept { return "Walker@" + std::to_string(position_); }
+
+ private:
+  int position_;
+};
+
+class Jumper {
+ public:
+  explicit Jumper(int height) : height_(height) {}
+  void Update(int delta) { height_ += delta * 2; }
+  std::string Describe() const noexcept { return "Jumper@" + std::to_string(height_); }
+
+ private:
+  int height_;
+  std::string padding_ = "padding";
+};
+
+struct Sitter {
+  void Update(int) {}
+  std::string Describe() const noexcept { return "Sitter"; }
+};
+
+struct Particle {
+  float x;
+  float v;
+};
+
+struct Anchor {
+  float x;
+};
+
+std::vector<std::size_t> integrated_spans;
+
+void Integrate(std::span<Particle> particles, float dt) noexcept {
+  integrated_spans.push_back(particles.size());
+  for (Particle& p : particles) {
+    p.x += p.v * dt;
+  }
+}
+void Integrate(std::span<Anchor> anchors, float) noexcept { integrated_spans.push_back(anchors.size()); }
+
+void poly::Nudge::bulk(std::span<Particle> particles, float dx) noexcept {
+  nudged_spans.push_back(particles.size());
+  for (Particle& p : particles) {
+    p.x += dx;
+  }
+}
+
+}  // namespace
+
+TEST(ProxyPolyVectorTests, TestSegmentation) {
+  pro::poly_vector<poly::Entity> v;
+  ASSERT_TRUE(v.empty());
+  v.emplace_back<Walker>(1);
+  v.emplace_back<Jumper>(10);
+  v.push_back(Walker{2});
+  v.emplace_back<Jumper>(20);
+  v.emplace_back<Walker>(3);
+  ASSERT_EQ(v.size(), 5u);
+  ASSERT_EQ(v.segment_count(), 2u);
+  ASSERT_EQ(v.segment_of<Walker>().size(), 3u);
+  ASSERT_EQ(v.segment_of<Jumper>().size(), 2u);
+  ASSERT_TRUE(v.segment_of<Sitter>().empty());
+}
+
+TEST(ProxyPolyVectorTests, TestSegmentIndex) {
+  struct Local { void Update(int) {} std::string Describe() const noexcept { return "Local"; } };
+  pro::poly_vector<poly::Entity> v1;
+  v1.emplace_back<Local>();
+  pro::poly_vector<poly::Entity> v2;
+  v2.emplace_back<Sitter>();
+  v2.emplace_back<Walker>(1);
+  v2.emplace_back<Sitter>();
+  ASSERT_EQ(v2.segment_count(), 2u);
+  ASSERT_TRUE(v2.segment_of<Local>().empty());
+  ASSERT_EQ(v2.segment_of<Sitter>().size(), 2u);
+  ASSERT_EQ(v2.segment_of<Walker>()[0].Describe(), "Walker@1");
+  ASSERT_EQ(v1.segment_of<Local>().size(), 1u);
+  ASSERT_TRUE(v1.segment_of<Walker>().empty());
+  v2.clear();
+  ASSERT_TRUE(v2.empty());
+  ASSERT_TRUE(v2.segment_of<Sitter>().empty());
+}
+
+TEST(ProxyPolyVectorTests, TestInvokeEach) {
+  pro::poly_vector<poly::Entity> v;
+  v.emplace_back<Walker>(1);
+  v.emplace_back<Jumper>(10);
+  v.emplace_back<Walker>(2);
+  v.invoke_each<poly::Update>(5);
+  std::vector<std::string> descriptions;
+  v.for_each([&](pro::proxy<poly::Entity> p) { descriptions.push_back(p.invoke<poly::Describe>()); });
+  ASSERT_EQ(descriptions, (std::vector<std::string>{"Walker@6", "Walker@7", "Jumper@20"}));
+}
+
+TEST(ProxyPolyVectorTests, TestClearAndMove) {
+  pro::poly_vector<poly::Entity> v;
+  v.emplace_back<Walker>(1);
+  v.emplace_back<Jumper>(10);
+  pro::poly_vector<poly::Entity> v2 = std::move(v);
+  ASSERT_EQ(v2.size(), 2u);
+  v2.clear();
+  ASSERT_TRUE(v2.empty());
+  v2.emplace_back<Jumper>(3);
+  ASSERT_EQ(v2.segment_of<Jumper>().size(), 1u);
+}
+
+TEST(ProxyPolyVectorTests, TestInvokeBulk) {
+  integrated_spans.clear();
+  pro::poly_vector<poly::Body> v;
+  for (int i = 0; i < 100; ++i) {
+    v.emplace_back<Particle>(static_cast<float>(i), 1.f);
+  }
+  v.emplace_back<Anchor>(-1.f);
+  v.emplace_back<Anchor>(-2.f);
+  v.invoke_bulk<poly::Advance>(0.5f);
+  ASSERT_EQ(integrated_spans, (std::vector<std::size_t>{100u, 2u}));
+  ASSERT_EQ(v.segment_of<Particle>()[10].x, 10.5f);
+  std::vector<float> xs;
+  v.for_each([&](pro::proxy<poly::Body> p) {
+    p.invoke<poly::Advance>(2.f);
+    xs.push_back(p.invoke<poly::x>());
+  });
+  ASSERT_EQ(integrated_spans.size(), 104u);
+  ASSERT_EQ(integrated_spans.back(), 1u);
+  ASSERT_EQ(xs[1], 3.5f);
+  ASSERT_EQ(xs[101], -2.f);
+}
+
+TEST(ProxyPolyVectorTests, TestInvokeBulk_Fallback) {
+  nudged_spans.clear();
+  pro::poly_vector<poly::Nudgeable> v;
+  v.emplace_back<Particle>(1.f, 0.f);
+  v.emplace_back<Anchor>(-1.f);
+  v.emplace_back<Particle>(2.f, 0.f);
+  v.emplace_back<Anchor>(-2.f);
+  v.invoke_bulk<poly::Nudge>(0.5f);
+  ASSERT_EQ(nudged_spans, std::vector<std::size_t>{2u});
+  std::vector<float> xs;
+  v.for_each([&](pro::proxy<poly::Nudgeable> p) { xs.push_back(p.invoke<poly::x>()); });
+  ASSERT_EQ(xs, (std::vector<float>{1.5f, 2.5f, -0.5f, -1.5f}));
+}
@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "proxy.h"
+#include "utils.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Value, int() noexcept);
+PRO_DEF_FACADE(Message, Value);
+PRO_DEF_FACADE(Stringable, utils::poly::ToString);
+
+}  // namespace poly
+
+class Number {
+ public:
+  explicit Number(int value) noexcept : value_(value) {}
+  int Value() const noexcept { return value_; }
+
+ private:
+  int value_;
+};
+
+class ThrowingNumber : public Number {
+ public:
+  explicit ThrowingNumber(int value) : Number(value) {
+    if (value < 0) {
+      throw std::runtime_error{"negative"};
+    }
+  }
+};
+
+template <class Queue>
+void ProduceAndConsume(Queue& queue, int producers, int consumers, int count) {
+  std::atomic<long long> sum = 0;
+  std::atomic<int> consumed = 0;
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      for (int i = 1; i <= count; ++i) {
+        while (!queue.template try_make<Number>(i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      while (consumed.load() < producers * count) {
+        if (!queue.try_consume([&](auto& m) { sum += m.template invoke<poly::Value>(); })) {
+          std::this_thread::yield();
+          continue;
+        }
+        ++consumed;
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(sum.load(), static_cast<long long>(producers) * count * (count + 1) / 2);
+}
+
+}  // namespace
+
+TEST(ProxyQueueTests, TestSpscInPlace) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  pro::spsc_proxy_queue<poly::Stringable> queue{3u};
+  ASSERT_EQ(queue.capacity(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_make<utils::LifetimeTracker::Session>(&tracker));
+    expected_ops.emplace_back(i + 1, utils::LifetimeOperationType::kValueConstruction);
+  }
+  ASSERT_FALSE(queue.try_make<utils::LifetimeTracker::Session>(&tracker));
+  ASSERT_TRUE(queue.try_consume([](pro::proxy<poly::Stringable>& p) { ASSERT_EQ(p(), "Session 1"); }));
+  expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  {
+    pro::proxy<poly::Stringable> out;
+    ASSERT_TRUE(queue.try_pop(out));
+    expected_ops.emplace_back(5, utils::LifetimeOperationType::kMoveConstruction);
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+    ASSERT_EQ(out(), "Session 5");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(5, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
+
+TEST(ProxyQueueTests, TestSpscConcurrent) {
+  pro::spsc_proxy_queue<poly::Message> queue{64u};
+  ProduceAndConsume(queue, 1, 1, 100000);
+}
+
+TEST(ProxyQueueTests, TestMpmcConcurrent) {
+  pro::mpmc_proxy_queue<poly::Message> queue{64u};
+  ProduceAndConsume(queue, 3, 3, 20000);
+}
+
+TEST(ProxyQueueTests, TestMpmcThrowingConstruction) {
+  pro::mpmc_proxy_queue<poly::Message> queue{4u};
+  ASSERT_TRUE(queue.try_make<ThrowingNumber>(1));
+  ASSERT_THROW(queue.try_make<ThrowingNumber>(-1), std::runtime_error);
+  ASSERT_TRUE(queue.try_make<ThrowingNumber>(3));
+  pro::proxy<poly::Message> out;
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(out.invoke<poly::Value>(), 1);
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(out.invoke<poly::Value>(), 3);
+  ASSERT_FALSE(queue.try_pop(out));
+}
+
+TEST(ProxyQueueTests, TestMpmcPush) {
+  pro::mpmc_proxy_queue<poly::Message> queue{2u};
+  pro::proxy<poly::Message> in = pro::make_proxy<poly::Message, ThrowingNumber>(1);
+  ASSERT_TRUE(queue.try_push(in));
+  ASSERT_FALSE(in.has_value());
+  in = pro::make_proxy<poly::Message, ThrowingNumber>(2);
+  ASSERT_TRUE(queue.try_push(in));
+  in = pro::make_proxy<poly::Message, ThrowingNumber>(3);
+  ASSERT_FALSE(queue.try_push(in));
+  ASSERT_EQ(in.invoke<poly::Value>(), 3);
+  pro::proxy<poly::Message> out;
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(out.invoke<poly::Value>(), 1);
+  ASSERT_TRUE(queue.try_push(in));
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(out.invoke<poly::Value>(), 2);
+  ASSERT_TRUE(queue.try_pop(out));
+  ASSERT_EQ(out.invoke<poly::Value>(), 3);
+  ASSERT_FALSE(queue.try_pop(out));
+}
@@ -13,6 +13,11 @@ concept ReflectionApplicable = requires(pro::proxy<F> p) {
   { p.reflect() };
 };
 
+template <class P, class F>
+concept ProxyCastApplicable = requires(pro::proxy<F>& p) {
+  { pro::proxy_cast<P>(std::move(p)) };
+};
+
 class RttiReflection {
  public:
   template <class P>
@@ -51,6 +56,19 @@ static_assert(ReflectionApplicable<TestRttiFacade>);
 PRO_DEF_FACADE(TestTraitsFacade, PRO_MAKE_DISPATCH_PACK(), pro::relocatable_ptr_constraints, TraitsReflection);
 static_assert(ReflectionApplicable<TestTraitsFacade>);
 
+PRO_DEF_FACADE(TestColdRttiFacade, PRO_MAKE_DISPATCH_PACK(), pro::relocatable_ptr_constraints, RttiReflection, pro::facade_options{.separate_cold_meta = true});
+static_assert(ReflectionApplicable<TestColdRttiFacade>);
+
+PRO_DEF_FACADE(TestIndestructibleFacade, PRO_MAKE_DISPATCH_PACK(), pro::proxiable_ptr_constraints{
+    .max_size = sizeof(void*),
+    .max_align = alignof(void*),
+    .copyability = pro::constraint_level::none,
+    .relocatability = pro::constraint_level::none,
+    .destructibility = pro::constraint_level::none,
+  }, TraitsReflection);
+static_assert(ProxyCastApplicable<int*, TestTraitsFacade>);
+static_assert(!ProxyCastApplicable<int*, TestIndestructibleFacade>);  // Unable to reset
+
 }  // namespace
 
 TEST(ProxyReflectionTests, TestRtti_RawPtr) {
@@ -82,3 +100,47 @@ TEST(ProxyReflectionTests, TestTraits_FancyPtr) {
   ASSERT_EQ(p.reflect().is_nothrow_destructible_, true);
   ASSERT_EQ(p.reflect().is_trivial_, false);
 }
+
+TEST(ProxyReflectionTests, TestRtti_SeparateColdMeta) {
+  pro::proxy<TestColdRttiFacade> p = std::make_unique<double>(1.23);
+  ASSERT_EQ(p.reflect().GetName(), typeid(std::unique_ptr<double>).name());
+  auto p2 = std::move(p);
+  ASSERT_EQ(p2.reflect().GetName(), typeid(std::unique_ptr<double>).name());
+}
+
+TEST(ProxyReflectionTests, TestTypeQuery_RawPtr) {
+  int foo = 123;
+  pro::proxy<TestTraitsFacade> p = &foo;
+  ASSERT_TRUE(p.has_type<int*>());
+  ASSERT_FALSE(p.has_type<std::unique_ptr<double>>());
+  ASSERT_EQ(p.target<std::unique_ptr<double>>(), nullptr);
+  ASSERT_EQ(*p.target<int*>(), &foo);
+  const auto& cp = p;
+  ASSERT_EQ(*cp.target<int*>(), &foo);
+}
+
+TEST(ProxyReflectionTests, TestTypeQuery_Empty) {
+  pro::proxy<TestTraitsFacade> p;
+  ASSERT_FALSE(p.has_type<int*>());
+  ASSERT_EQ(p.target<int*>(), nullptr);
+}
+
+TEST(ProxyReflectionTests, TestProxyCast) {
+  pro::proxy<TestTraitsFacade> p = std::make_unique<double>(1.23);
+  std::unique_ptr<double> ptr = pro::proxy_cast<std::unique_ptr<double>>(std::move(p));
+  ASSERT_FALSE(p.has_value());
+  ASSERT_EQ(*ptr, 1.23);
+}
+
+TEST(ProxyReflectionTests, TestProxyCast_Mismatch) {
+  int foo = 123;
+  pro::proxy<TestTraitsFacade> p = &foo;
+  bool exception_thrown = false;
+  try {
+    pro::proxy_cast<std::unique_ptr<double>>(std::move(p));
+  } catch (const pro::bad_proxy_cast&) {
+    exception_thrown = true;
+  }
+  ASSERT_TRUE(exception_thrown);
+  ASSERT_TRUE(p.has_type<int*>());
+}
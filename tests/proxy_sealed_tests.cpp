@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "proxy.h"
+#include "utils.h"
+
+namespace {
+
+namespace poly {
+
+PRO_DEF_MEMBER_DISPATCH(Area, double() noexcept);
+PRO_DEF_MEMBER_DISPATCH(Scale, void(double factor));
+PRO_DEF_FACADE(Shape, PRO_MAKE_DISPATCH_PACK(Area, Scale));
+PRO_DEF_FACADE(Stringable, utils::poly::ToString);
+
+}  // namespace poly
+
+class Square {
+ public:
+  explicit Square(double side) : side_(side) {}
+  double Area() const noexcept { return side_ * side_; }
+  void Scale(double factor) { side_ *= factor; }
+
+ private:
+  double side_;
+};
+
+class Rectangle {
+ public:
+  Rectangle(double width, double height) : width_(width), height_(height) {}
+  double Area() const noexcept { return width_ * height_; }
+  void Scale(double factor) { width_ *= factor; height_ *= factor; }
+
+ private:
+  double width_;
+  double height_;
+};
+
+using SealedShape = pro::sealed_proxy<poly::Shape, Square, Rectangle>;
+using SealedStringable = pro::sealed_proxy<poly::Stringable, int, utils::LifetimeTracker::Session>;
+
+static_assert(sizeof(SealedShape) == sizeof(double) * 3u);
+static_assert(std::is_trivially_destructible_v<SealedShape>);
+static_assert(!std::is_trivially_destructible_v<SealedStringable>);
+static_assert(noexcept(std::declval<const SealedShape&>().invoke<poly::Area>()));
+static_assert(!noexcept(std::declval<const SealedShape&>().invoke<poly::Scale>(1.0)));
+
+// Larger than the two pointers allowed by the constraints of poly::Shape
+class Polygon {
+ public:
+  double Area() const noexcept { return 0.0; }
+  void Scale(double) {}
+
+ private:
+  double vertices_[6] = {};
+};
+
+template <class F, class... Ts>
+concept SealedApplicable = requires { typename pro::sealed_proxy<F, Ts...>; };
+
+static_assert(SealedApplicable<poly::Shape, Square, Rectangle>);
+static_assert(!SealedApplicable<poly::Shape, Square, Polygon>);
+
+}  // namespace
+
+TEST(ProxySealedTests, TestInvoke) {
+  std::vector<SealedShape> shapes;
+  shapes.emplace_back(Square{2.0});
+  shapes.emplace_back(std::in_place_type<Rectangle>, 2.0, 3.0);
+  double total = 0.0;
+  for (const auto& s : shapes) {
+    s.invoke<poly::Scale>(2.0);
+    total += s.invoke<poly::Area>();
+  }
+  ASSERT_EQ(total, 16.0 + 24.0);
+  ASSERT_TRUE(shapes[0].has_type<Square>());
+  ASSERT_FALSE(shapes[0].has_type<Rectangle>());
+  ASSERT_EQ(shapes[1].target<Square>(), nullptr);
+  ASSERT_EQ(shapes[1].target<Rectangle>()->Area(), 24.0);
+}
+
+TEST(ProxySealedTests, TestDefaultDispatch) {
+  SealedStringable p = 123;
+  ASSERT_EQ(p(), "123");
+  p = SealedStringable{};
+  ASSERT_FALSE(p.has_value());
+}
+
+TEST(ProxySealedTests, TestInvokeEmpty) {
+  SealedStringable p;
+  ASSERT_THROW(p(), pro::bad_proxy_invocation);
+  SealedStringable q = 123;
+  SealedStringable r = std::move(q);
+  ASSERT_EQ(r(), "123");
+  ASSERT_THROW(q(), pro::bad_proxy_invocation);
+}
+
+TEST(ProxySealedTests, TestLifetime) {
+  utils::LifetimeTracker tracker;
+  std::vector<utils::LifetimeOperation> expected_ops;
+  {
+    SealedStringable p1{std::in_place_type<utils::LifetimeTracker::Session>, &tracker};
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kValueConstruction);
+    SealedStringable p2 = p1;
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kCopyConstruction);
+    SealedStringable p3 = std::move(p1);
+    expected_ops.emplace_back(3, utils::LifetimeOperationType::kMoveConstruction);
+    expected_ops.emplace_back(1, utils::LifetimeOperationType::kDestruction);
+    ASSERT_FALSE(p1.has_value());
+    ASSERT_EQ(p2.invoke(), "Session 2");
+    ASSERT_EQ(p3.invoke(), "Session 3");
+    p2.emplace<int>(7);
+    expected_ops.emplace_back(2, utils::LifetimeOperationType::kDestruction);
+    ASSERT_EQ(p2.invoke(), "7");
+    ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+  }
+  expected_ops.emplace_back(3, utils::LifetimeOperationType::kDestruction);
+  ASSERT_TRUE(tracker.GetOperations() == expected_ops);
+}
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <memory>
 #include <type_traits>
 #include "proxy.h"
 
@@ -154,6 +155,33 @@ static_assert(pro::proxiable<MockCopyableSmallPtr, RelocatableFacadeWithReflecti
 static_assert(pro::proxiable<MockTrivialPtr, RelocatableFacadeWithReflection>);
 static_assert(pro::proxiable<MockFunctionPtr, RelocatableFacadeWithReflection>);
 
+PRO_DEF_FACADE(TriviallyRelocatableFacade, PRO_MAKE_DISPATCH_PACK(), pro::proxiable_ptr_constraints{
+    .max_size = sizeof(void*) * 2u,
+    .max_align = alignof(void*),
+    .copyability = pro::constraint_level::none,
+    .relocatability = pro::constraint_level::trivial,
+    .destructibility = pro::constraint_level::nothrow,
+  });
+PRO_DEF_FACADE(TriviallyRelocatableByTraitFacade, PRO_MAKE_DISPATCH_PACK(), pro::proxiable_ptr_constraints{
+    .max_size = sizeof(void*) * 2u,
+    .max_align = alignof(void*),
+    .copyability = pro::constraint_level::none,
+    .relocatability = pro::constraint_level::trivial,
+    .destructibility = pro::constraint_level::nothrow,
+  }, void, pro::facade_options{.relocatable_by_trait = true});
+static_assert(pro::is_trivially_relocatable_v<MockTrivialPtr>);
+static_assert(!pro::is_trivially_relocatable_v<MockMovablePtr>);
+static_assert(pro::is_trivially_relocatable_v<std::unique_ptr<int>>);
+static_assert(pro::is_trivially_relocatable_v<std::shared_ptr<int>>);
+static_assert(pro::proxiable<MockTrivialPtr, TriviallyRelocatableFacade>);
+static_assert(!pro::proxiable<MockMovablePtr, TriviallyRelocatableFacade>);
+static_assert(!pro::proxiable<std::unique_ptr<int>, TriviallyRelocatableFacade>);
+static_assert(!pro::proxiable<std::shared_ptr<int>, TriviallyRelocatableFacade>);
+static_assert(pro::proxiable<MockTrivialPtr, TriviallyRelocatableByTraitFacade>);
+static_assert(!pro::proxiable<MockMovablePtr, TriviallyRelocatableByTraitFacade>);
+static_assert(pro::proxiable<std::unique_ptr<int>, TriviallyRelocatableByTraitFacade>);
+static_assert(pro::proxiable<std::shared_ptr<int>, TriviallyRelocatableByTraitFacade>);
+
 struct BadFacade_MissingDispatchTypes {
 #ifdef __clang__
 #pragma clang diagnostic push